@@ -3,8 +3,11 @@ import path from "node:path";
 
 const root = process.cwd();
 const emsdkDir = path.join(root, "source", "emsdk");
+// --threads 额外构建 occt-wasm-mt（pthread + SharedArrayBuffer）
+const threads = process.argv.includes("--threads");
+const cmakeArgs = threads ? " -DOCCT_WASM_THREADS=ON" : "";
 const buildCore =
-  "pnpm clean:build && cd build && emcmake cmake .. -G Ninja && cmake --build .";
+  `pnpm clean:build && cd build && emcmake cmake .. -G Ninja${cmakeArgs} && cmake --build .`;
 
 const isWin = process.platform === "win32";
 const fullCmd = isWin
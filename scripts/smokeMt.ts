@@ -0,0 +1,54 @@
+import path from "node:path";
+import { pathToFileURL } from "node:url";
+
+// 冒烟测试 occt-wasm-mt：在 Worker 线程池上并行划分一个立方体并检查输出
+// 用法：tsx scripts/smokeMt.ts [build/occt-wasm-mt.js]
+const modulePath = path.resolve(process.argv[2] ?? path.join("build", "occt-wasm-mt.js"));
+
+function check(condition: boolean, message: string) {
+  if (!condition) {
+    console.error(`[smoke:mt] FAIL ${message}`);
+    process.exit(1);
+  }
+}
+
+async function main() {
+  const { default: factory } = await import(pathToFileURL(modulePath).href);
+  const occt = await factory();
+
+  const threads = occt.Mesher.setThreadCount(0);
+  occt.Mesher.setParallel(true);
+  check(threads >= 1 && occt.Mesher.getThreadCount() === threads, `thread count ${threads}`);
+  console.log(`[smoke:mt] threads: ${threads}`);
+
+  const axis = {
+    origin: { x: 0, y: 0, z: 0 },
+    xDirection: { x: 1, y: 0, z: 0 },
+    yDirection: { x: 0, y: 1, z: 0 },
+  };
+  const box = occt.GeometryFactory.Box(10, 20, 30, axis);
+  check(box.status, `Box: ${box.message}`);
+  const shape = box.takeShape();
+  box.delete();
+
+  const packed = occt.Mesher.toPackedMesh(shape, { lineDeflection: 0.1, angleDeviation: 0.5 });
+  const mesh = packed.toObject();
+  const vertexCount = mesh.position.length / 3;
+  check(packed.getFaceCount() === 6, `face count ${packed.getFaceCount()}`);
+  check(packed.getEdgeCount() === 12, `edge count ${packed.getEdgeCount()}`);
+  check(mesh.index.length >= 36 && mesh.index.length % 3 === 0, `index length ${mesh.index.length}`);
+  check(Number.isInteger(vertexCount) && vertexCount >= 24, `position length ${mesh.position.length}`);
+  check(mesh.index.every((i: number) => i < vertexCount), "index out of range");
+  console.log(`[smoke:mt] ${vertexCount} vertices, ${mesh.index.length / 3} triangles`);
+
+  packed.delete();
+  shape.delete();
+  console.log("[smoke:mt] OK");
+  // Worker 线程会让进程保持运行
+  process.exit(0);
+}
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
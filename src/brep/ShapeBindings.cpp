@@ -2,6 +2,7 @@
 #include "TopoDS_Vertex.hxx"
 #include "TopoDS_Wire.hxx"
 #include "brep/ShapeBindings.h"
+#include "mesh/MeshBindings.h"
 #include "shared/Shared.hpp"
 #include <cmath>
 #include <emscripten/bind.h>
@@ -73,55 +74,49 @@ void appendCommonPrtPoints(emscripten::val& result, const IntTools_CommonPrt& cp
 }
 
 template<typename T>
-emscripten::val vectorToTypedArray(const std::vector<T>& vec) {
+emscripten::val vectorToTypedArray(const std::vector<T>& vec, bool asView = false) {
     if (vec.empty()) return emscripten::val::null();
-    emscripten::val result = emscripten::val::global("Float32Array").new_(vec.size());
-    for (size_t i = 0; i < vec.size(); i++) {
-        result.set(i, vec[i]);
-    }
-    return result;
+    return asView ? toMemoryView(vec) : copyToTypedArray(vec);
 }
 
-template<>
-emscripten::val vectorToTypedArray<uint32_t>(const std::vector<uint32_t>& vec) {
-    if (vec.empty()) return emscripten::val::null();
-    emscripten::val result = emscripten::val::global("Uint32Array").new_(vec.size());
-    for (size_t i = 0; i < vec.size(); i++) {
-        result.set(i, vec[i]);
-    }
-    return result;
+template<typename T>
+emscripten::val vectorToTypedArrayOrEmpty(const std::vector<T>& vec, bool asView = false) {
+    if (vec.empty()) return emscripten::val::global(TypedArrayName<T>::value).new_(0);
+    return asView ? toMemoryView(vec) : copyToTypedArray(vec);
 }
 
-emscripten::val faceResultToObject(const FaceResult& result) {
+/**
+ * asView 为 true 时，返回对象中的 TypedArray 直接引用 result 在 wasm 堆上的内存，
+ * 仅在 result 存活且 wasm 内存未增长期间有效
+ */
+emscripten::val faceResultToObject(const FaceResult& result, bool asView = false) {
     using emscripten::val;
     val obj = val::object();
-    val positionVal = vectorToTypedArray(result.position);
-    val indexVal = vectorToTypedArray(result.index);
-    val normalVal = vectorToTypedArray(result.normal);
-    val uvVal = vectorToTypedArray(result.uv);
-    obj.set("position", positionVal.isNull() ? val::global("Float32Array").new_(0) : positionVal);
-    obj.set("index", indexVal.isNull() ? val::global("Uint32Array").new_(0) : indexVal);
-    obj.set("normal", normalVal.isNull() ? val::global("Float32Array").new_(0) : normalVal);
-    obj.set("uv", uvVal.isNull() ? val::global("Float32Array").new_(0) : uvVal);
+    obj.set("position", vectorToTypedArrayOrEmpty(result.position, asView));
+    obj.set("index", vectorToTypedArrayOrEmpty(result.index, asView));
+    obj.set("normal", vectorToTypedArrayOrEmpty(result.normal, asView));
+    obj.set("uv", vectorToTypedArrayOrEmpty(result.uv, asView));
     return obj;
 }
 
-emscripten::val edgeResultToObject(const EdgeResult& result) {
+emscripten::val edgeResultToObject(const EdgeResult& result, bool asView = false) {
     using emscripten::val;
     val obj = val::object();
-    obj.set("position", vectorToTypedArray(result.position));
+    obj.set("position", vectorToTypedArray(result.position, asView));
     return obj;
 }
 
-emscripten::val brepResultToObject(const BRepResult& result) {
+/**
+ * 先为所有子 shape 建立 JS 句柄再创建 TypedArray：句柄构造会在 wasm 堆上分配，
+ * asView 为 true 时若在视图之后分配，内存增长会使先前的视图失效
+ */
+emscripten::val brepResultToObject(const BRepResult& result, bool asView = false) {
     using emscripten::val;
     val obj = val::object();
 
     val vertices = val::array();
     for (const auto& v : result.vertices) {
         val vertex = val::object();
-        val position = vectorToTypedArray(v.position);
-        vertex.set("position", position.isNull() ? val::global("Float32Array").new_(0) : position);
         if (v.shape.IsNull()) {
             vertex.set("shape", val::null());
         } else {
@@ -134,8 +129,6 @@ emscripten::val brepResultToObject(const BRepResult& result) {
     val edges = val::array();
     for (const auto& e : result.edges) {
         val edge = val::object();
-        val position = vectorToTypedArray(e.position);
-        edge.set("position", position.isNull() ? val::global("Float32Array").new_(0) : position);
         edge.set("type", static_cast<int>(e.type));
         if (e.shape.IsNull()) {
             edge.set("shape", val::null());
@@ -149,14 +142,6 @@ emscripten::val brepResultToObject(const BRepResult& result) {
     val faces = val::array();
     for (const auto& f : result.faces) {
         val face = val::object();
-        val position = vectorToTypedArray(f.position);
-        val index = vectorToTypedArray(f.index);
-        val uv = vectorToTypedArray(f.uv);
-        val normal = vectorToTypedArray(f.normal);
-        face.set("position", position.isNull() ? val::global("Float32Array").new_(0) : position);
-        face.set("index", index.isNull() ? val::global("Uint32Array").new_(0) : index);
-        face.set("uv", uv.isNull() ? val::global("Float32Array").new_(0) : uv);
-        face.set("normal", normal.isNull() ? val::global("Float32Array").new_(0) : normal);
         if (f.shape.IsNull()) {
             face.set("shape", val::null());
         } else {
@@ -166,16 +151,22 @@ emscripten::val brepResultToObject(const BRepResult& result) {
     }
     obj.set("faces", faces);
 
-    return obj;
-}
-
-template<typename TopoType>
-emscripten::val topoVectorToArray(const std::vector<TopoType>& shapes) {
-    emscripten::val result = emscripten::val::array();
-    for (const auto& shape : shapes) {
-        result.call<void>("push", shape);
+    for (size_t i = 0; i < result.vertices.size(); ++i) {
+        vertices[i].set("position", vectorToTypedArrayOrEmpty(result.vertices[i].position, asView));
     }
-    return result;
+    for (size_t i = 0; i < result.edges.size(); ++i) {
+        edges[i].set("position", vectorToTypedArrayOrEmpty(result.edges[i].position, asView));
+    }
+    for (size_t i = 0; i < result.faces.size(); ++i) {
+        const auto& f = result.faces[i];
+        val face = faces[i];
+        face.set("position", vectorToTypedArrayOrEmpty(f.position, asView));
+        face.set("index", vectorToTypedArrayOrEmpty(f.index, asView));
+        face.set("uv", vectorToTypedArrayOrEmpty(f.uv, asView));
+        face.set("normal", vectorToTypedArrayOrEmpty(f.normal, asView));
+    }
+
+    return obj;
 }
 
 } // namespace
@@ -300,6 +291,51 @@ EdgeResult Edge::discretize(const TopoDS_Edge& edge, double lineDeflection = Con
   return result;
 }
 
+EdgeResult Edge::readPolyline(const TopoDS_Edge& edge, double lineDeflection, double angleDeviation) {
+  EdgeResult result;
+
+  TopLoc_Location loc;
+  Handle(Poly_Polygon3D) polygon3D = BRep_Tool::Polygon3D(edge, loc);
+
+  if (!polygon3D.IsNull()) {
+      const TColgp_Array1OfPnt& nodes = polygon3D->Nodes();
+      result.position.reserve(nodes.Length() * 3);
+
+      for (Standard_Integer i = nodes.Lower(); i <= nodes.Upper(); i++) {
+          gp_Pnt pnt = nodes.Value(i);
+          if (!loc.IsIdentity()) {
+              pnt.Transform(loc.Transformation());
+          }
+          result.position.push_back(static_cast<float>(pnt.X()));
+          result.position.push_back(static_cast<float>(pnt.Y()));
+          result.position.push_back(static_cast<float>(pnt.Z()));
+      }
+      return result;
+  }
+
+  Handle(Poly_Triangulation) triangulation;
+  Handle(Poly_PolygonOnTriangulation) polygonOnTri;
+  BRep_Tool::PolygonOnTriangulation(edge, polygonOnTri, triangulation, loc);
+
+  if (!polygonOnTri.IsNull() && !triangulation.IsNull()) {
+      const TColStd_Array1OfInteger& indices = polygonOnTri->Nodes();
+      result.position.reserve(indices.Length() * 3);
+
+      for (Standard_Integer i = indices.Lower(); i <= indices.Upper(); i++) {
+          gp_Pnt pnt = triangulation->Node(indices.Value(i));
+          if (!loc.IsIdentity()) {
+              pnt.Transform(loc.Transformation());
+          }
+          result.position.push_back(static_cast<float>(pnt.X()));
+          result.position.push_back(static_cast<float>(pnt.Y()));
+          result.position.push_back(static_cast<float>(pnt.Z()));
+      }
+      return result;
+  }
+
+  return Edge::discretize(edge, lineDeflection, angleDeviation);
+}
+
 GeomAbs_CurveType Edge::getCurveType(const TopoDS_Edge& edge) {
   if (BRep_Tool::Degenerated(edge)) {
       return GeomAbs_OtherCurve;
@@ -377,14 +413,21 @@ double Face::area(const TopoDS_Face& face) {
 }
 
 FaceResult Face::triangulate(const TopoDS_Face& face, double deflection = Constants::LINE_DEFLECTION, double angleDeviation = Constants::ANGLE_DEFLECTION) {
+  MeshOptions options(deflection, angleDeviation);
+  MeshCache::ensureTriangulation(face, options);
+  return Face::readTriangulation(face, options);
+}
+
+FaceResult Face::readTriangulation(const TopoDS_Face& face) {
+  return Face::readTriangulation(face, MeshOptions());
+}
+
+FaceResult Face::readTriangulation(const TopoDS_Face& face, const MeshOptions& options) {
   FaceResult result;
 
   TopLoc_Location loc;
   Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
 
-  BRepMesh_IncrementalMesh mesher(face, deflection, Standard_False, angleDeviation, Standard_True);
-  triangulation = BRep_Tool::Triangulation(face, loc);
-
   if (triangulation.IsNull()) {
       return result;
   }
@@ -427,73 +470,36 @@ FaceResult Face::triangulate(const TopoDS_Face& face, double deflection = Consta
       }
   }
 
-  if (triangulation->HasNormals()) {
+  if (triangulation->HasUVNodes()) {
+      result.uv.reserve(nbNodes * 2);
+      for (Standard_Integer i = 1; i <= nbNodes; i++) {
+          gp_Pnt2d uvPnt = triangulation->UVNode(i);
+          result.uv.push_back(static_cast<float>(uvPnt.X()));
+          result.uv.push_back(static_cast<float>(uvPnt.Y()));
+      }
+  }
+
+  // 法线方向与变换后的三角形绕序保持一致
+  if (options.normalMode == NormalMode::Surface && triangulation->HasNormals()) {
       result.normal.reserve(nbNodes * 3);
       for (Standard_Integer i = 1; i <= nbNodes; i++) {
           gp_Dir normal = triangulation->Normal(i);
-          if ((isReversed ^ isMirrored)) {
-              normal.Reverse();
-          }
           if (!loc.IsIdentity()) {
-              gp_Vec normalVec(normal);
-              normalVec.Transform(trsf);
-              normal = gp_Dir(normalVec);
+              normal.Transform(trsf);
+          }
+          if (isReversed) {
+              normal.Reverse();
           }
           result.normal.push_back(static_cast<float>(normal.X()));
           result.normal.push_back(static_cast<float>(normal.Y()));
           result.normal.push_back(static_cast<float>(normal.Z()));
       }
+  } else if (options.normalMode == NormalMode::Surface && MeshNormals::fromSurface(face, result)) {
+      // 曲面法线已写入 result.normal
+  } else if (options.creaseAngle > 0.0) {
+      MeshNormals::splitCreases(result, options.normalMode, options.creaseAngle);
   } else {
-      Poly_Connect connect(triangulation);
-      result.normal.reserve(nbNodes * 3);
-      for (Standard_Integer i = 1; i <= nbNodes; i++) {
-          gp_Vec normalVec(0.0, 0.0, 0.0);
-
-          for (Standard_Integer j = 1; j <= nbTriangles; j++) {
-              Poly_Triangle triangle = triangulation->Triangle(j);
-              Standard_Integer n1, n2, n3;
-              triangle.Get(n1, n2, n3);
-
-              if (n1 == i || n2 == i || n3 == i) {
-                  gp_Pnt p1 = triangulation->Node(n1);
-                  gp_Pnt p2 = triangulation->Node(n2);
-                  gp_Pnt p3 = triangulation->Node(n3);
-
-                  gp_Vec v1(p1, p2);
-                  gp_Vec v2(p1, p3);
-                  gp_Vec faceNormal = v1.Crossed(v2);
-
-                  if (faceNormal.Magnitude() > Precision::Confusion()) {
-                      normalVec.Add(faceNormal);
-                  }
-              }
-          }
-
-          if (normalVec.Magnitude() > Precision::Confusion()) {
-              normalVec.Normalize();
-              if ((isReversed ^ isMirrored)) {
-                  normalVec.Reverse();
-              }
-              if (!loc.IsIdentity()) {
-                  normalVec.Transform(trsf);
-              }
-          } else {
-              normalVec = gp_Vec(0.0, 0.0, 1.0);
-          }
-
-          result.normal.push_back(static_cast<float>(normalVec.X()));
-          result.normal.push_back(static_cast<float>(normalVec.Y()));
-          result.normal.push_back(static_cast<float>(normalVec.Z()));
-      }
-  }
-
-  if (triangulation->HasUVNodes()) {
-      result.uv.reserve(nbNodes * 2);
-      for (Standard_Integer i = 1; i <= nbNodes; i++) {
-          gp_Pnt2d uvPnt = triangulation->UVNode(i);
-          result.uv.push_back(static_cast<float>(uvPnt.X()));
-          result.uv.push_back(static_cast<float>(uvPnt.Y()));
-      }
+      MeshNormals::accumulate(result, options.normalMode);
   }
 
   return result;
@@ -652,7 +658,8 @@ bool Shape::isClosed(const TopoDS_Shape& shape) {
 BRepResult Shape::toBRepResult(const TopoDS_Shape& shape, double lineDeflection, double angleDeviation) {
   BRepResult result;
 
-  BRepMesh_IncrementalMesh mesher(shape, lineDeflection, Standard_False, angleDeviation, Standard_True);
+  MeshOptions options(lineDeflection, angleDeviation);
+  MeshCache::ensureTriangulation(shape, options);
 
   std::vector<TopoDS_Vertex> vertices = Shape::getVertices(shape);
   for (const TopoDS_Vertex& v : vertices) {
@@ -669,76 +676,33 @@ BRepResult Shape::toBRepResult(const TopoDS_Shape& shape, double lineDeflection,
           continue;
       }
 
-      BRepEdge brepEdge;
-      brepEdge.type = Edge::getCurveType(edge);
-      brepEdge.shape = edge;
-
-      TopLoc_Location loc;
-      Handle(Poly_Polygon3D) polygon3D = BRep_Tool::Polygon3D(edge, loc);
-
-      if (!polygon3D.IsNull()) {
-          const TColgp_Array1OfPnt& nodes = polygon3D->Nodes();
-          brepEdge.position.reserve(nodes.Length() * 3);
-
-          for (Standard_Integer i = nodes.Lower(); i <= nodes.Upper(); i++) {
-              gp_Pnt pnt = nodes.Value(i);
-              if (!loc.IsIdentity()) {
-                  pnt.Transform(loc.Transformation());
-              }
-              brepEdge.position.push_back(static_cast<float>(pnt.X()));
-              brepEdge.position.push_back(static_cast<float>(pnt.Y()));
-              brepEdge.position.push_back(static_cast<float>(pnt.Z()));
-          }
-      } else {
-          Handle(Poly_Triangulation) triangulation;
-          Handle(Poly_PolygonOnTriangulation) polygonOnTri;
-          BRep_Tool::PolygonOnTriangulation(edge, polygonOnTri, triangulation, loc);
-
-          if (!polygonOnTri.IsNull() && !triangulation.IsNull()) {
-              const TColStd_Array1OfInteger& indices = polygonOnTri->Nodes();
-              brepEdge.position.reserve(indices.Length() * 3);
-
-              for (Standard_Integer i = indices.Lower(); i <= indices.Upper(); i++) {
-                  gp_Pnt pnt = triangulation->Node(indices.Value(i));
-                  if (!loc.IsIdentity()) {
-                      pnt.Transform(loc.Transformation());
-                  }
-                  brepEdge.position.push_back(static_cast<float>(pnt.X()));
-                  brepEdge.position.push_back(static_cast<float>(pnt.Y()));
-                  brepEdge.position.push_back(static_cast<float>(pnt.Z()));
-              }
-          } else {
-              EdgeResult disc = Edge::discretize(edge, lineDeflection, angleDeviation);
-              if (disc.position.size() >= 6) {
-                  brepEdge.position = disc.position;
-              } else {
-                  continue;
-              }
-          }
-      }
-
-      if (brepEdge.position.size() < 6) {
+      EdgeResult polyline = Edge::readPolyline(edge, lineDeflection, angleDeviation);
+      if (polyline.position.size() < 6) {
           continue;
       }
 
-      result.edges.push_back(brepEdge);
+      BRepEdge brepEdge;
+      brepEdge.type = Edge::getCurveType(edge);
+      brepEdge.shape = edge;
+      brepEdge.position = std::move(polyline.position);
+      result.edges.push_back(std::move(brepEdge));
   }
 
   std::vector<TopoDS_Face> faces = Shape::getFaces(shape);
   for (const TopoDS_Face& face : faces) {
-      FaceResult faceResult = Face::triangulate(face, lineDeflection, angleDeviation);
+      FaceResult faceResult = Face::readTriangulation(face, options);
 
       if (faceResult.position.empty() || faceResult.index.empty()) {
           continue;
       }
 
       BRepFace brepFace;
-      brepFace.position = faceResult.position;
-      brepFace.index = faceResult.index;
-      brepFace.uv = faceResult.uv;
-      brepFace.normal = faceResult.normal;
+      brepFace.position = std::move(faceResult.position);
+      brepFace.index = std::move(faceResult.index);
+      brepFace.uv = std::move(faceResult.uv);
+      brepFace.normal = std::move(faceResult.normal);
       brepFace.shape = face;
-      result.faces.push_back(brepFace);
+      result.faces.push_back(std::move(brepFace));
   }
 
   return result;
@@ -769,6 +733,22 @@ EMSCRIPTEN_BINDINGS(ShapeBindings) {
   register_vector<float>("FloatVector");
   register_vector<uint32_t>("Uint32Vector");
 
+  // 结果对象保留在 wasm 堆上，toObject() 返回零拷贝视图，使用完毕需调用 delete() 释放
+  class_<EdgeResult>("EdgeResult")
+      .function("toObject", optional_override([](const EdgeResult& self) {
+        return edgeResultToObject(self, true);
+      }));
+
+  class_<FaceResult>("FaceResult")
+      .function("toObject", optional_override([](const FaceResult& self) {
+        return faceResultToObject(self, true);
+      }));
+
+  class_<BRepResult>("BRepResult")
+      .function("toObject", optional_override([](const BRepResult& self) {
+        return brepResultToObject(self, true);
+      }));
+
   class_<Vertex>("Vertex")
       .class_function("toVector3", &Vertex::toVector3)
       .class_function("fromPoint", &Vertex::fromPoint);
@@ -794,6 +774,10 @@ EMSCRIPTEN_BINDINGS(ShapeBindings) {
             double angleDeviation = optAngleDeviation.isUndefined() ? Constants::ANGLE_DEFLECTION : optAngleDeviation.as<double>();
             EdgeResult result = Edge::discretize(edge, lineDeflection, angleDeviation);
             return edgeResultToObject(result);
+          }))
+      .class_function("discretizeView", optional_override(
+          [](const TopoDS_Edge& edge, double lineDeflection, double angleDeviation) {
+            return Edge::discretize(edge, lineDeflection, angleDeviation);
           }));
 
   class_<Wire>("Wire")
@@ -809,6 +793,10 @@ EMSCRIPTEN_BINDINGS(ShapeBindings) {
           [](const TopoDS_Face& face, double deflection, double angleDeviation) {
             FaceResult result = Face::triangulate(face, deflection, angleDeviation);
             return faceResultToObject(result);
+          }))
+      .class_function("triangulateView", optional_override(
+          [](const TopoDS_Face& face, double deflection, double angleDeviation) {
+            return Face::triangulate(face, deflection, angleDeviation);
           }));
 
   class_<Shell>("Shell")
@@ -854,6 +842,10 @@ EMSCRIPTEN_BINDINGS(ShapeBindings) {
           [](const TopoDS_Shape& shape, double lineDeflection, double angleDeviation) {
             BRepResult result = Shape::toBRepResult(shape, lineDeflection, angleDeviation);
             return brepResultToObject(result);
+          }))
+      .class_function("toBRepResultView", optional_override(
+          [](const TopoDS_Shape& shape, double lineDeflection, double angleDeviation) {
+            return Shape::toBRepResult(shape, lineDeflection, angleDeviation);
           }));
 
 }
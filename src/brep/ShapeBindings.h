@@ -16,6 +16,7 @@
 #include <vector>
 
 class Geom_Curve;
+struct MeshOptions;
 
 struct EdgeResult {
   std::vector<float> position;
@@ -69,6 +70,8 @@ public:
   static Vector3 pointAt(const TopoDS_Edge& edge, double t);
   static TopoDS_Edge trim(const TopoDS_Edge& edge, double start, double end);
   static EdgeResult discretize(const TopoDS_Edge& edge, double lineDeflection, double angleDeviation);
+  // 优先读取已有的 Polygon3D / PolygonOnTriangulation，没有时再离散曲线
+  static EdgeResult readPolyline(const TopoDS_Edge& edge, double lineDeflection, double angleDeviation);
   static GeomAbs_CurveType getCurveType(const TopoDS_Edge& edge);
 };
 
@@ -85,6 +88,9 @@ public:
   static TopoDS_Face fromVertices(const Vector3Array& outerVertices, const Vector3ArrayArray& innerVertices);
   static double area(const TopoDS_Face& face);
   static FaceResult triangulate(const TopoDS_Face& face, double deflection, double angleDeviation);
+  // 只读取面上已有的三角化，不触发网格划分；法线按 options.normalMode / creaseAngle 生成
+  static FaceResult readTriangulation(const TopoDS_Face& face);
+  static FaceResult readTriangulation(const TopoDS_Face& face, const MeshOptions& options);
 };
 
 class Shell {
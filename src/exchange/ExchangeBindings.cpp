@@ -1,25 +1,70 @@
 #include "ExchangeBindings.h"
 #include "brep/ShapeBindings.h"
+#include "mesh/MeshBindings.h"
 #include "shared/Shared.hpp"
 
 #include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
 #include <BRepTools.hxx>
+#include <BinTools.hxx>
+#include <BinTools_FormatVersion.hxx>
+#include <BRepLib_ToolTriangulatedShape.hxx>
+#include <TopTools_FormatVersion.hxx>
+#include <TopTools_OrientedShapeMapHasher.hxx>
 #include <Quantity_Color.hxx>
+#include <Quantity_ColorRGBA.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <STEPCAFControl_Writer.hxx>
+#include <STEPControl_Reader.hxx>
+#include <StepBasic_Product.hxx>
+#include <StepBasic_ProductDefinition.hxx>
+#include <StepBasic_ProductDefinitionFormation.hxx>
+#include <StepData_StepModel.hxx>
+#include <StepGeom_CartesianPoint.hxx>
+#include <StepRepr_CharacterizedDefinition.hxx>
+#include <StepRepr_NextAssemblyUsageOccurrence.hxx>
+#include <StepRepr_PropertyDefinition.hxx>
+#include <StepRepr_RepresentedDefinition.hxx>
+#include <StepRepr_ShapeRepresentationRelationship.hxx>
+#include <StepRepr_RepresentationRelationshipWithTransformation.hxx>
+#include <StepShape_ShapeDefinitionRepresentation.hxx>
+#include <StepVisual_Colour.hxx>
+#include <StepVisual_StyledItem.hxx>
+#include <STEPConstruct_Styles.hxx>
+#include <Transfer_TransientProcess.hxx>
+#include <TransferBRep.hxx>
+#include <XSControl_TransferReader.hxx>
+#include <XSControl_WorkSession.hxx>
+#include <Interface_EntityIterator.hxx>
+#include <Interface_ShareTool.hxx>
+#include <NCollection_DataMap.hxx>
+#include <TColStd_MapOfTransient.hxx>
 #include <STEPControl_StepModelType.hxx>
+#include <DESTEP_Parameters.hxx>
+#include <ShapeProcess.hxx>
+#include <XSControl_Reader.hxx>
 #include <IGESCAFControl_Reader.hxx>
 #include <IGESCAFControl_Writer.hxx>
+#include <Message_ProgressIndicator.hxx>
+#include <Message_ProgressRange.hxx>
+#include <Message_ProgressScope.hxx>
+#include <Poly_Triangle.hxx>
+#include <Poly_Triangulation.hxx>
+#include <RWStl_Reader.hxx>
+#include <Standard_ReadLineBuffer.hxx>
 #include <StlAPI_Reader.hxx>
-#include <StlAPI_Writer.hxx>
-#include <BRepMesh_IncrementalMesh.hxx>
 #include <TDF_ChildIterator.hxx>
 #include <TDF_Label.hxx>
+#include <TDF_LabelIntegerMap.hxx>
+#include <TDF_LabelSequence.hxx>
+#include <TDF_Tool.hxx>
+#include <TCollection_AsciiString.hxx>
 #include <TDataStd_Name.hxx>
 #include <TDocStd_Document.hxx>
 #include <TopoDS_Iterator.hxx>
 #include <TopLoc_Location.hxx>
 #include <TopoDS_Shape.hxx>
+#include <TopoDS_TShape.hxx>
 #include <XCAFDoc_ColorTool.hxx>
 #include <XCAFDoc_ColorType.hxx>
 #include <XCAFDoc_DocumentTool.hxx>
@@ -27,17 +72,32 @@
 #include <IFSelect_ReturnStatus.hxx>
 #include <TCollection_ExtendedString.hxx>
 #include <TopoDS_Compound.hxx>
+#include <TopoDS_Face.hxx>
+#include <gp.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_XYZ.hxx>
 
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
+#include <emscripten/emscripten.h>
+#ifdef OCCT_WASM_THREADS
+#include <emscripten/threading.h>
+#endif
 
 #include <sstream>
 #include <fstream>
+#include <memory>
 #include <vector>
 #include <string>
 #include <optional>
+#include <unordered_map>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 using namespace emscripten;
 
@@ -46,18 +106,20 @@ public:
     VectorBuffer(const std::vector<uint8_t>& v) {
         setg((char*)v.data(), (char*)v.data(), (char*)(v.data() + v.size()));
     }
-};
-
-EMSCRIPTEN_DECLARE_VAL_TYPE(ShapeNodeArray)
 
-struct ShapeNode {
-    std::optional<TopoDS_Shape> shape;
-    std::optional<std::string> color;
-    std::vector<ShapeNode> children;
-    std::string name;
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        char* base = dir == std::ios_base::beg ? eback() : (dir == std::ios_base::cur ? gptr() : egptr());
+        return seekpos(pos_type(base - eback() + off), which);
+    }
 
-    ShapeNodeArray getChildren() const {
-        return ShapeNodeArray(val::array(children));
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        const off_type offset = static_cast<off_type>(pos);
+        if (!(which & std::ios_base::in) || offset < 0 || offset > egptr() - eback()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + offset, egptr());
+        return pos;
     }
 };
 
@@ -247,10 +309,238 @@ ShapeNode parseDocumentToNode(Handle(TDocStd_Document) document) {
     return root;
 }
 
+// ==================== XCAF Document → instances ====================
+
+/** 按列主序追加 16 个矩阵元素 */
+void appendMatrix(std::vector<double>& matrix, const TopLoc_Location& location) {
+    const gp_Trsf trsf = location.Transformation();
+    for (int column = 1; column <= 4; column++) {
+        for (int row = 1; row <= 3; row++) {
+            matrix.push_back(trsf.Value(row, column));
+        }
+        matrix.push_back(column == 4 ? 1.0 : 0.0);
+    }
+}
+
+/**
+ * 沿 XCAF 引用展开装配：每个被引用的零件 label 只生成一个原型，每次出现记录原型序号和累计位置。
+ * 实例名称优先取引用 label 自身的名称（装配中的出现名），颜色先查引用再查零件
+ */
+class InstanceCollector {
+public:
+    explicit InstanceCollector(const Handle(TDocStd_Document)& document)
+        : shapeTool(XCAFDoc_DocumentTool::ShapeTool(document->Main())),
+          colorTool(XCAFDoc_DocumentTool::ColorTool(document->Main())) {
+        TDF_LabelSequence freeShapes;
+        shapeTool->GetFreeShapes(freeShapes);
+        for (const TDF_Label& label : freeShapes) {
+            visit(label, TopLoc_Location(), label);
+        }
+    }
+
+    val toObject() const {
+        val prototypes = val::array();
+        for (const TDF_Label& label : prototypeLabels) {
+            val prototype = val::object();
+            prototype.set("shape", shapeTool->GetShape(label));
+            prototype.set("name", getLabelNameNoRef(label));
+            std::string color;
+            if (getLabelColorNoRef(label, colorTool, color)) {
+                prototype.set("color", color);
+            }
+            prototypes.call<void>("push", prototype);
+        }
+
+        val colors = val::array();
+        for (const std::optional<std::string>& color : instanceColors) {
+            colors.call<void>("push", color.has_value() ? val(color.value()) : val::undefined());
+        }
+        val instances = val::object();
+        instances.set("prototype", copyToTypedArray(instancePrototype));
+        instances.set("matrix", copyToTypedArray(instanceMatrix));
+        instances.set("names", val::array(instanceNames));
+        instances.set("colors", colors);
+
+        val assembly = val::object();
+        assembly.set("prototypes", prototypes);
+        assembly.set("instances", instances);
+        return assembly;
+    }
+
+private:
+    void visit(const TDF_Label& label, const TopLoc_Location& location, const TDF_Label& occurrence) {
+        if (XCAFDoc_ShapeTool::IsAssembly(label)) {
+            TDF_LabelSequence components;
+            XCAFDoc_ShapeTool::GetComponents(label, components);
+            for (const TDF_Label& component : components) {
+                TDF_Label referred;
+                if (XCAFDoc_ShapeTool::GetReferredShape(component, referred)) {
+                    visit(referred, location * XCAFDoc_ShapeTool::GetLocation(component), component);
+                }
+            }
+            return;
+        }
+
+        TopoDS_Shape shape;
+        if (!shapeTool->GetShape(label, shape)) {
+            return;
+        }
+        Standard_Integer prototype = static_cast<Standard_Integer>(prototypeLabels.size());
+        if (const Standard_Integer* found = prototypeIndex.Seek(label)) {
+            prototype = *found;
+        } else {
+            prototypeIndex.Bind(label, prototype);
+            prototypeLabels.push_back(label);
+        }
+
+        std::string name = getLabelNameNoRef(occurrence);
+        if (name.empty()) {
+            name = getLabelNameNoRef(label);
+        }
+        std::string color;
+        instancePrototype.push_back(static_cast<uint32_t>(prototype));
+        instanceNames.push_back(name);
+        instanceColors.push_back(getLabelColor(occurrence, shapeTool, colorTool, color)
+            ? std::make_optional(color) : std::nullopt);
+
+        appendMatrix(instanceMatrix, location);
+    }
+
+    Handle(XCAFDoc_ShapeTool) shapeTool;
+    Handle(XCAFDoc_ColorTool) colorTool;
+    TDF_LabelIntegerMap prototypeIndex;
+    std::vector<TDF_Label> prototypeLabels;
+    std::vector<uint32_t> instancePrototype;
+    std::vector<double> instanceMatrix;
+    std::vector<std::string> instanceNames;
+    std::vector<std::optional<std::string>> instanceColors;
+};
+
+val documentToInstances(const Handle(TDocStd_Document)& document) {
+    return InstanceCollector(document).toObject();
+}
+
+// ==================== XCAF Document → FlatAssembly ====================
+
+bool getLabelRGBA(const TDF_Label& label, const Handle(XCAFDoc_ShapeTool)& shapeTool,
+    const Handle(XCAFDoc_ColorTool)& colorTool, uint32_t& rgba) {
+    static const std::vector<XCAFDoc_ColorType> colorTypes = {
+        XCAFDoc_ColorSurf, XCAFDoc_ColorCurv, XCAFDoc_ColorGen
+    };
+    Quantity_ColorRGBA color;
+    for (XCAFDoc_ColorType colorType : colorTypes) {
+        if (colorTool->GetColor(label, colorType, color)) {
+            Standard_Real r, g, b;
+            color.GetRGB().Values(r, g, b, Quantity_TOC_sRGB);
+            auto toByte = [](double value) {
+                return static_cast<uint32_t>(std::clamp(value, 0.0, 1.0) * 255.0 + 0.5);
+            };
+            rgba = toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(color.Alpha()) << 24);
+            return true;
+        }
+    }
+    if (XCAFDoc_ShapeTool::IsReference(label)) {
+        TDF_Label ref;
+        shapeTool->GetReferredShape(label, ref);
+        return getLabelRGBA(ref, shapeTool, colorTool, rgba);
+    }
+    return false;
+}
+
+/**
+ * 与 InstanceCollector 相同沿引用展开，但保留装配层级：装配和零件的每次出现各为一个节点，
+ * 矩阵为组件相对父装配的位置，零件 shape 按 label 去重
+ */
+class FlatAssemblyBuilder {
+public:
+    explicit FlatAssemblyBuilder(const Handle(TDocStd_Document)& document)
+        : shapeTool(XCAFDoc_DocumentTool::ShapeTool(document->Main())),
+          colorTool(XCAFDoc_DocumentTool::ColorTool(document->Main())) {
+        flat.nameOffset.push_back(0);
+        const int32_t root = addNode(-1, std::string(), 0, TopLoc_Location(), -1);
+        TDF_LabelSequence freeShapes;
+        shapeTool->GetFreeShapes(freeShapes);
+        for (const TDF_Label& label : freeShapes) {
+            visit(label, label, root, TopLoc_Location());
+        }
+    }
+
+    FlatAssembly take() { return std::move(flat); }
+
+private:
+    int32_t addNode(int32_t parent, const std::string& name, uint32_t rgba, const TopLoc_Location& location,
+        int32_t shape) {
+        flat.parentIndex.push_back(parent);
+        flat.color.push_back(rgba);
+        appendMatrix(flat.matrix, location);
+        flat.nameData.insert(flat.nameData.end(), name.begin(), name.end());
+        flat.nameOffset.push_back(static_cast<uint32_t>(flat.nameData.size()));
+        flat.shapeIndex.push_back(shape);
+        return static_cast<int32_t>(flat.parentIndex.size() - 1);
+    }
+
+    void visit(const TDF_Label& label, const TDF_Label& occurrence, int32_t parent, const TopLoc_Location& location) {
+        std::string name = getLabelNameNoRef(occurrence);
+        if (name.empty()) {
+            name = getLabelNameNoRef(label);
+        }
+        uint32_t rgba = 0;
+        getLabelRGBA(occurrence, shapeTool, colorTool, rgba);
+
+        if (XCAFDoc_ShapeTool::IsAssembly(label)) {
+            const int32_t node = addNode(parent, name, rgba, location, -1);
+            TDF_LabelSequence components;
+            XCAFDoc_ShapeTool::GetComponents(label, components);
+            for (const TDF_Label& component : components) {
+                TDF_Label referred;
+                if (XCAFDoc_ShapeTool::GetReferredShape(component, referred)) {
+                    visit(referred, component, node, XCAFDoc_ShapeTool::GetLocation(component));
+                }
+            }
+            return;
+        }
+
+        int32_t shape = -1;
+        if (const Standard_Integer* found = shapeIndex.Seek(label)) {
+            shape = *found;
+        } else {
+            TopoDS_Shape labelShape;
+            if (shapeTool->GetShape(label, labelShape)) {
+                shape = static_cast<int32_t>(flat.shapes.size());
+                flat.shapes.push_back(labelShape);
+                shapeIndex.Bind(label, shape);
+            }
+        }
+        addNode(parent, name, rgba, location, shape);
+    }
+
+    Handle(XCAFDoc_ShapeTool) shapeTool;
+    Handle(XCAFDoc_ColorTool) colorTool;
+    TDF_LabelIntegerMap shapeIndex;
+    FlatAssembly flat;
+};
+
+FlatAssembly documentToFlatAssembly(const Handle(TDocStd_Document)& document) {
+    return FlatAssemblyBuilder(document).take();
+}
+
+/** shapes 的句柄会在 wasm 堆上分配，先于各列视图创建，避免内存增长使视图失效 */
+val flatAssemblyToObject(const FlatAssembly& flat) {
+    val obj = val::object();
+    obj.set("shapes", topoVectorToArray(flat.shapes));
+    obj.set("parentIndex", toMemoryView(flat.parentIndex));
+    obj.set("color", toMemoryView(flat.color));
+    obj.set("matrix", toMemoryView(flat.matrix));
+    obj.set("nameOffset", toMemoryView(flat.nameOffset));
+    obj.set("nameData", toMemoryView(flat.nameData));
+    obj.set("shapeIndex", toMemoryView(flat.shapeIndex));
+    return obj;
+}
+
 // ==================== I/O helpers ====================
 
 void writeBufferToFile(const std::string& fileName, const Uint8Array& buffer) {
-    std::vector<uint8_t> input = convertJSArrayToNumberVector<uint8_t>(buffer);
+    std::vector<uint8_t> input = uint8ArrayToVector(buffer);
     std::ofstream file(fileName, std::ios::binary);
     file.write(reinterpret_cast<const char*>(input.data()), input.size());
     file.close();
@@ -264,11 +554,40 @@ val toUint8Array(const std::string& data) {
     return uint8Array;
 }
 
-std::string fromUint8Array(const Uint8Array& buffer) {
-    std::vector<uint8_t> vec = convertJSArrayToNumberVector<uint8_t>(buffer);
-    return std::string(vec.begin(), vec.end());
-}
+/**
+ * 读取 Uint8Array 或 HeapBuffer 的输入流，Uint8Array 会先复制到堆上，release 后立即释放
+ */
+class SourceStream {
+public:
+    explicit SourceStream(const val& source) : sourceSize(0), stream(nullptr) {
+        if (source.instanceof(val::global("Uint8Array"))) {
+            data = uint8ArrayToVector(Uint8Array(source));
+            sourceSize = data.size();
+            streamBuf = std::make_unique<VectorBuffer>(data);
+        } else {
+            const HeapBuffer& buffer = *source.as<HeapBuffer*>(allow_raw_pointers());
+            sourceSize = buffer.size();
+            streamBuf = std::make_unique<HeapBufferStreamBuf>(buffer);
+        }
+        stream.rdbuf(streamBuf.get());
+    }
+
+    std::istream& get() { return stream; }
+    // 源数据字节数，release 后仍可用
+    size_t size() const { return sourceSize; }
+
+    void release() {
+        stream.rdbuf(nullptr);
+        streamBuf.reset();
+        std::vector<uint8_t>().swap(data);
+    }
 
+private:
+    std::vector<uint8_t> data;
+    size_t sourceSize;
+    std::unique_ptr<std::streambuf> streamBuf;
+    std::istream stream;
+};
 
 // ==================== ShapeNode → XCAF Document ====================
 
@@ -278,69 +597,449 @@ Quantity_Color parseHexColor(const std::string& hex) {
     return color;
 }
 
+void setLabelName(const TDF_Label& label, const std::string& name) {
+    if (!name.empty()) {
+        TDataStd_Name::Set(label, TCollection_ExtendedString(name.c_str(), Standard_True));
+    }
+}
+
+/** 不带位置的原型 shape → 零件 label，朝向不同的同一 TShape 视为不同零件 */
+using PartLabelMap = NCollection_DataMap<TopoDS_Shape, TDF_Label, TopTools_OrientedShapeMapHasher>;
+using ShapeUsageMap = NCollection_DataMap<TopoDS_Shape, Standard_Integer, TopTools_OrientedShapeMapHasher>;
+
+/**
+ * 以不带位置的 shape 作为零件只添加一次，之后的出现作为带位置的组件引用同一零件。
+ * 第一次出现的名称和颜色写在零件上，之后的出现与零件不同时写在组件 label 上
+ */
+TDF_Label addPartComponent(const TDF_Label& parentLabel, const TopoDS_Shape& prototype, const TopLoc_Location& location,
+    const std::string& name, const std::optional<std::string>& color,
+    const Handle(XCAFDoc_ShapeTool)& shapeTool, const Handle(XCAFDoc_ColorTool)& colorTool, PartLabelMap& parts) {
+    if (const TDF_Label* found = parts.Seek(prototype)) {
+        TDF_Label component = shapeTool->AddComponent(parentLabel, *found, location);
+        if (name != getLabelNameNoRef(*found)) {
+            setLabelName(component, name);
+        }
+        std::string partColor;
+        getLabelColorNoRef(*found, colorTool, partColor);
+        if (color.has_value() && color.value() != partColor) {
+            colorTool->SetColor(component, parseHexColor(color.value()), XCAFDoc_ColorSurf);
+        }
+        return component;
+    }
+
+    TDF_Label part = shapeTool->AddShape(prototype, Standard_False);
+    setLabelName(part, name);
+    if (color.has_value()) {
+        colorTool->SetColor(part, parseHexColor(color.value()), XCAFDoc_ColorSurf);
+    }
+    parts.Bind(prototype, part);
+    return shapeTool->AddComponent(parentLabel, part, location);
+}
+
+/** 以空 compound 建立装配 label，parentLabel 非空时作为其组件 */
+TDF_Label addAssembly(const std::string& name, const std::optional<std::string>& color,
+    const Handle(XCAFDoc_ShapeTool)& shapeTool, const Handle(XCAFDoc_ColorTool)& colorTool, const TDF_Label& parentLabel) {
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    TDF_Label asmLabel = shapeTool->AddShape(compound, Standard_True);
+    setLabelName(asmLabel, name);
+    if (color.has_value()) {
+        colorTool->SetColor(asmLabel, parseHexColor(color.value()), XCAFDoc_ColorSurf);
+    }
+    if (!parentLabel.IsNull()) {
+        shapeTool->AddComponent(parentLabel, asmLabel, TopLoc_Location());
+    }
+    return asmLabel;
+}
+
 void addNodeToDocument(const ShapeNode& node,
     const Handle(XCAFDoc_ShapeTool)& shapeTool,
     const Handle(XCAFDoc_ColorTool)& colorTool,
-    const TDF_Label& parentLabel) {
+    const TDF_Label& parentLabel,
+    PartLabelMap& parts) {
 
     if (node.shape.has_value()) {
-        TDF_Label label = shapeTool->AddShape(node.shape.value(), Standard_False);
-        if (!node.name.empty()) {
-            TDataStd_Name::Set(label,
-                TCollection_ExtendedString(node.name.c_str(), Standard_True));
+        const TopoDS_Shape& shape = node.shape.value();
+        if (!parentLabel.IsNull()) {
+            addPartComponent(parentLabel, shape.Located(TopLoc_Location()), shape.Location(),
+                node.name, node.color, shapeTool, colorTool, parts);
+            return;
         }
+        TDF_Label label = shapeTool->AddShape(shape, Standard_False);
+        setLabelName(label, node.name);
         if (node.color.has_value()) {
             colorTool->SetColor(label, parseHexColor(node.color.value()), XCAFDoc_ColorSurf);
         }
-        if (!parentLabel.IsNull()) {
-            shapeTool->AddComponent(parentLabel, label, TopLoc_Location());
-        }
         return;
     }
 
     if (node.children.empty()) return;
 
-    TopoDS_Compound compound;
-    BRep_Builder builder;
-    builder.MakeCompound(compound);
-    TDF_Label asmLabel = shapeTool->AddShape(compound, Standard_True);
-    if (!node.name.empty()) {
-        TDataStd_Name::Set(asmLabel,
-            TCollection_ExtendedString(node.name.c_str(), Standard_True));
+    TDF_Label asmLabel = addAssembly(node.name, node.color, shapeTool, colorTool, parentLabel);
+    for (const auto& child : node.children) {
+        addNodeToDocument(child, shapeTool, colorTool, asmLabel, parts);
     }
-    if (node.color.has_value()) {
-        colorTool->SetColor(asmLabel, parseHexColor(node.color.value()), XCAFDoc_ColorSurf);
+}
+
+void countShapeUsage(const ShapeNode& node, ShapeUsageMap& usage) {
+    if (node.shape.has_value()) {
+        const TopoDS_Shape prototype = node.shape.value().Located(TopLoc_Location());
+        if (Standard_Integer* count = usage.ChangeSeek(prototype)) {
+            (*count)++;
+        } else {
+            usage.Bind(prototype, 1);
+        }
     }
-    if (!parentLabel.IsNull()) {
-        shapeTool->AddComponent(parentLabel, asmLabel, TopLoc_Location());
+    for (const auto& child : node.children) {
+        countShapeUsage(child, usage);
     }
+}
 
-    for (const auto& child : node.children) {
-        addNodeToDocument(child, shapeTool, colorTool, asmLabel);
+/**
+ * 顶层叶节点的 TShape 在树中出现多次时，顶层节点无法引用共享零件，
+ * 此时为根节点建立装配，所有节点都以组件形式挂在其下
+ */
+bool needsRootAssembly(const ShapeNode& root) {
+    ShapeUsageMap usage;
+    countShapeUsage(root, usage);
+    for (const auto& child : root.children) {
+        if (child.shape.has_value() && usage.Find(child.shape.value().Located(TopLoc_Location())) > 1) {
+            return true;
+        }
     }
+    return false;
 }
 
-Handle(TDocStd_Document) buildDocumentFromNode(const ShapeNode& root) {
+Handle(TDocStd_Document) createDocument() {
     Handle(TDocStd_Document) doc = new TDocStd_Document("MDTV-XCAF");
     XCAFDoc_DocumentTool::Set(doc->Main());
+    return doc;
+}
+
+/**
+ * 树中共享 TShape 的叶节点只写出一个零件，各次出现作为带位置的组件引用，
+ * 导出文件中保持为一个产品加多个 NAUO，不再复制几何
+ */
+Handle(TDocStd_Document) buildDocumentFromNode(const ShapeNode& root) {
+    Handle(TDocStd_Document) doc = createDocument();
     Handle(XCAFDoc_ShapeTool) shapeTool = XCAFDoc_DocumentTool::ShapeTool(doc->Main());
     Handle(XCAFDoc_ColorTool) colorTool = XCAFDoc_DocumentTool::ColorTool(doc->Main());
 
+    PartLabelMap parts;
+    const TDF_Label rootLabel = needsRootAssembly(root)
+        ? addAssembly(root.name, root.color, shapeTool, colorTool, TDF_Label()) : TDF_Label();
     for (const auto& child : root.children) {
-        addNodeToDocument(child, shapeTool, colorTool, TDF_Label());
+        addNodeToDocument(child, shapeTool, colorTool, rootLabel, parts);
     }
 
     shapeTool->UpdateAssemblies();
     return doc;
 }
 
-// ==================== STEP ====================
+std::string getAssemblyName(const val& options) {
+    if (options.isUndefined() || options.isNull() || options["name"].isUndefined()) {
+        return std::string();
+    }
+    return options["name"].as<std::string>();
+}
 
-std::optional<ShapeNode> importSTEP(const Uint8Array& buffer) {
-    std::vector<uint8_t> input = convertJSArrayToNumberVector<uint8_t>(buffer);
-    VectorBuffer vectorBuffer(input);
-    std::istream iss(&vectorBuffer);
+/**
+ * 按列主序的 4x4 矩阵，只取仿射部分。
+ * 含非有限值或线性部分奇异时返回 std::nullopt，这类矩阵会使 gp_Trsf::SetValues 抛出异常
+ */
+std::optional<gp_Trsf> matrixToTrsf(const double* m) {
+    for (int i = 0; i < 16; i++) {
+        if (!std::isfinite(m[i])) {
+            return std::nullopt;
+        }
+    }
+    const double det = m[0] * (m[5] * m[10] - m[9] * m[6])
+        - m[4] * (m[1] * m[10] - m[9] * m[2])
+        + m[8] * (m[1] * m[6] - m[5] * m[2]);
+    if (std::abs(det) <= gp::Resolution()) {
+        return std::nullopt;
+    }
+    gp_Trsf trsf;
+    trsf.SetValues(m[0], m[4], m[8], m[12],
+                   m[1], m[5], m[9], m[13],
+                   m[2], m[6], m[10], m[14]);
+    return trsf;
+}
+
+/**
+ * 由 importSTEPInstanced / importIGESInstanced 返回的 assembly 结构建立文档：
+ * 每个原型一个零件，每个实例一个带矩阵位置的组件，全部挂在名为 name 的根装配下。
+ * matrix 元素少于实例数 × 16 时返回空文档；原型序号越界或矩阵奇异的实例跳过
+ */
+Handle(TDocStd_Document) buildDocumentFromInstances(const val& assembly, const std::string& name) {
+    Handle(TDocStd_Document) doc = createDocument();
+    Handle(XCAFDoc_ShapeTool) shapeTool = XCAFDoc_DocumentTool::ShapeTool(doc->Main());
+    Handle(XCAFDoc_ColorTool) colorTool = XCAFDoc_DocumentTool::ColorTool(doc->Main());
+
+    TDF_Label rootLabel = addAssembly(name, std::nullopt, shapeTool, colorTool, TDF_Label());
+
+    const val prototypes = assembly["prototypes"];
+    const val instances = assembly["instances"];
+    const val names = instances["names"];
+    const val colors = instances["colors"];
+    const uint32_t prototypeCount = prototypes["length"].as<uint32_t>();
+    // 实例的原型序号和矩阵各整块复制一次
+    std::vector<uint32_t> prototypeIndex(instances["prototype"]["length"].as<size_t>());
+    toMemoryView(prototypeIndex).call<void>("set", instances["prototype"]);
+    std::vector<double> matrices(prototypeIndex.size() * 16);
+    if (instances["matrix"]["length"].as<double>() < static_cast<double>(matrices.size())) {
+        return Handle(TDocStd_Document)();
+    }
+    toMemoryView(matrices).call<void>("set", instances["matrix"].call<val>("subarray", 0, matrices.size()));
+
+    std::vector<TopoDS_Shape> prototypeShapes;
+    std::vector<std::string> prototypeNames;
+    std::vector<std::optional<std::string>> prototypeColors;
+    for (uint32_t i = 0; i < prototypeCount; i++) {
+        const val prototype = prototypes[i];
+        const val color = prototype["color"];
+        prototypeShapes.push_back(prototype["shape"].as<TopoDS_Shape>());
+        prototypeNames.push_back(prototype["name"].isUndefined() ? std::string() : prototype["name"].as<std::string>());
+        prototypeColors.push_back(color.isUndefined() || color.isNull() ? std::nullopt : std::make_optional(color.as<std::string>()));
+    }
+
+    // 按原型的名称和颜色建立零件，实例的名称和颜色与原型不同时由 addPartComponent 写在组件上
+    PartLabelMap parts;
+    for (uint32_t i = 0; i < prototypeCount; i++) {
+        TDF_Label part = shapeTool->AddShape(prototypeShapes[i], Standard_False);
+        setLabelName(part, prototypeNames[i]);
+        if (prototypeColors[i].has_value()) {
+            colorTool->SetColor(part, parseHexColor(prototypeColors[i].value()), XCAFDoc_ColorSurf);
+        }
+        parts.Bind(prototypeShapes[i], part);
+    }
+
+    for (uint32_t i = 0; i < prototypeIndex.size(); i++) {
+        const uint32_t prototype = prototypeIndex[i];
+        const std::optional<gp_Trsf> trsf = matrixToTrsf(&matrices[i * 16]);
+        if (prototype >= prototypeCount || !trsf.has_value()) {
+            continue;
+        }
+        const val instanceName = names.isUndefined() ? val::undefined() : names[i];
+        const val instanceColor = colors.isUndefined() ? val::undefined() : colors[i];
+        addPartComponent(rootLabel, prototypeShapes[prototype], TopLoc_Location(trsf.value()),
+            instanceName.isUndefined() ? prototypeNames[prototype] : instanceName.as<std::string>(),
+            instanceColor.isUndefined() || instanceColor.isNull()
+                ? prototypeColors[prototype] : std::make_optional(instanceColor.as<std::string>()),
+            shapeTool, colorTool, parts);
+    }
 
+    shapeTool->UpdateAssemblies();
+    return doc;
+}
+
+// ==================== Progress ====================
+
+/**
+ * 把 OCCT 的进度转发给 JS，并把 JS 侧的取消请求转换为 UserBreak
+ * options: { onProgress?: (progress: number, phase: string) => boolean | void,
+ *            cancelToken?: Int32Array | { cancelled: boolean }, progressInterval?: number }
+ * onProgress 按 progressInterval（毫秒，默认 100）限频，切换阶段时总会回调一次，返回 false 表示取消。
+ * 导入在 worker 中同步执行，其他线程需通过 SharedArrayBuffer 上的 Int32Array 置位（首元素非 0）来取消
+ */
+class JSProgressIndicator : public Message_ProgressIndicator {
+public:
+    explicit JSProgressIndicator(const val& options)
+        : onProgress(val::undefined()), cancelToken(val::undefined()), interval(100.0),
+          lastReport(0.0), lastCheck(0.0), cancelled(false) {
+        if (options.isUndefined() || options.isNull()) {
+            return;
+        }
+        onProgress = options["onProgress"];
+        cancelToken = options["cancelToken"];
+        val progressInterval = options["progressInterval"];
+        if (!progressInterval.isUndefined()) interval = progressInterval.as<double>();
+    }
+
+    // 进入新阶段并立即回调
+    void setPhase(const std::string& name) {
+        phase = name;
+        report(true);
+    }
+
+    // 不限频地检查取消状态，用于阶段之间
+    bool isCancelled() {
+        return cancelled || checkToken(true);
+    }
+
+    Standard_Boolean UserBreak() override {
+        return cancelled || checkToken(false);
+    }
+
+protected:
+    void Show(const Message_ProgressScope&, const Standard_Boolean) override {
+        report(false);
+    }
+
+private:
+    // OCCT 可能在线程池中推进进度，val 只能在运行时所在线程上访问
+    static bool canCallJS() {
+#ifdef OCCT_WASM_THREADS
+        return emscripten_is_main_runtime_thread();
+#else
+        return true;
+#endif
+    }
+
+    void report(bool force) {
+        if (cancelled || onProgress.isUndefined() || onProgress.isNull() || !canCallJS()) {
+            return;
+        }
+        const double now = emscripten_get_now();
+        if (!force && now - lastReport < interval) {
+            return;
+        }
+        lastReport = now;
+        if (onProgress(GetPosition(), phase).strictlyEquals(val(false))) {
+            cancelled = true;
+        }
+    }
+
+    bool checkToken(bool force) {
+        if (cancelToken.isUndefined() || cancelToken.isNull() || !canCallJS()) {
+            return false;
+        }
+        const double now = emscripten_get_now();
+        if (!force && now - lastCheck < interval) {
+            return false;
+        }
+        lastCheck = now;
+        if (cancelToken.instanceof(val::global("Int32Array"))) {
+            cancelled = val::global("Atomics").call<int>("load", cancelToken, 0) != 0;
+        } else {
+            cancelled = cancelToken["cancelled"].as<bool>();
+        }
+        return cancelled;
+    }
+
+    val onProgress;
+    val cancelToken;
+    double interval;
+    double lastReport;
+    double lastCheck;
+    std::string phase;
+    bool cancelled;
+};
+
+ExportResult exportCancelled() {
+    return ExportResult(val::null(), false, "cancelled");
+}
+
+/**
+ * 分 parse / transfer / tree 三个阶段导入，进度权重 3 / 6 / 1，并记录各阶段耗时。
+ * read(stream) 返回 IFSelect_ReturnStatus，transfer(range) 返回是否成功，build() 返回 Result 的数据部分。
+ * ReadStream 不接受进度，解析阶段只在结束时检查取消；取消后 reader、模型和文档由调用方随返回一并释放
+ */
+template <typename Result, typename Read, typename Transfer, typename Build>
+Result readWithProgress(const char* format, const val& source, const val& options,
+    Read read, Transfer transfer, Build build) {
+    Handle(JSProgressIndicator) indicator = new JSProgressIndicator(options);
+    Message_ProgressScope scope(indicator->Start(), format, 10);
+    ImportTimings timings {};
+
+    indicator->setPhase("parse");
+    double start = emscripten_get_now();
+    SourceStream input(source);
+    const IFSelect_ReturnStatus readStatus = read(input.get());
+    input.release();
+    timings.parse = emscripten_get_now() - start;
+    if (readStatus != IFSelect_RetDone) {
+        return Result::failure("parse failed");
+    }
+    scope.Next(3);
+    if (indicator->isCancelled()) {
+        return Result::failure("cancelled");
+    }
+
+    indicator->setPhase("transfer");
+    start = emscripten_get_now();
+    const bool isTransferred = transfer(scope.Next(6));
+    timings.transfer = emscripten_get_now() - start;
+    if (indicator->isCancelled()) {
+        return Result::failure("cancelled");
+    }
+    if (!isTransferred) {
+        return Result::failure("transfer failed");
+    }
+
+    indicator->setPhase("tree");
+    start = emscripten_get_now();
+    Result result(build(), true, "");
+    timings.tree = emscripten_get_now() - start;
+    result.timings = timings;
+    scope.Next(1);
+    indicator->setPhase("done");
+    return result;
+}
+
+/**
+ * 通过 XCAF 文档导入，保留名称、颜色和装配结构，build(document) 从文档生成结果
+ */
+template <typename Result, typename Reader, typename Read, typename Build>
+Result readDocumentWithProgress(Reader& reader, const char* format, const val& source, const val& options,
+    Read read, Build build) {
+    reader.SetColorMode(true);
+    reader.SetNameMode(true);
+    Handle(TDocStd_Document) document = new TDocStd_Document("MDTV-XCAF");
+    XCAFDoc_DocumentTool::Set(document->Main());
+    return readWithProgress<Result>(format, source, options, read,
+        [&reader, &document](const Message_ProgressRange& range) {
+            return static_cast<bool>(reader.Transfer(document, range));
+        },
+        [&document, &build]() {
+            return build(document);
+        });
+}
+
+/**
+ * 分 build / transfer / write 三个阶段导出，进度权重 1 / 6 / 3
+ * build() 返回 XCAF 文档，输入无效时返回空 handle，transfer(document, range) 返回是否成功，write(stream) 返回是否成功
+ */
+template <typename Build, typename Transfer, typename Write>
+ExportResult writeWithProgress(const char* format, const val& options, Build build,
+    Transfer transfer, Write write) {
+    Handle(JSProgressIndicator) indicator = new JSProgressIndicator(options);
+    Message_ProgressScope scope(indicator->Start(), format, 10);
+
+    indicator->setPhase("build");
+    Handle(TDocStd_Document) document = build();
+    if (document.IsNull()) {
+        return ExportResult(val::null(), false, "build failed");
+    }
+    scope.Next(1);
+    if (indicator->isCancelled()) {
+        return exportCancelled();
+    }
+
+    indicator->setPhase("transfer");
+    const bool isTransferred = transfer(document, scope.Next(6));
+    if (indicator->isCancelled()) {
+        return exportCancelled();
+    }
+    if (!isTransferred) {
+        return ExportResult(val::null(), false, "transfer failed");
+    }
+
+    indicator->setPhase("write");
+    std::ostringstream oss;
+    if (!write(oss)) {
+        return ExportResult(val::null(), false, "write failed");
+    }
+    scope.Next(3);
+    indicator->setPhase("done");
+    return ExportResult(toUint8Array(oss.str()), true, "");
+}
+
+
+// ==================== STEP ====================
+
+std::optional<ShapeNode> readSTEP(std::istream& iss) {
     STEPCAFControl_Reader reader;
     reader.SetColorMode(true);
     reader.SetNameMode(true);
@@ -357,6 +1056,24 @@ std::optional<ShapeNode> importSTEP(const Uint8Array& buffer) {
     return parseDocumentToNode(document);
 }
 
+std::optional<ShapeNode> importSTEP(const Uint8Array& buffer) {
+    std::vector<uint8_t> input = uint8ArrayToVector(buffer);
+    VectorBuffer vectorBuffer(input);
+    std::istream iss(&vectorBuffer);
+    return readSTEP(iss);
+}
+
+/**
+ * @description: 从 HeapBuffer 导入 STEP，读取器直接消费堆上的分块数据，峰值内存约为一份文件
+ * @param {HeapBuffer&} buffer JS 已写入的文件数据，导入后可调用 clear() 释放
+ * @return {ShapeNode | undefined}
+ */
+std::optional<ShapeNode> importSTEPFromBuffer(const HeapBuffer& buffer) {
+    HeapBufferStreamBuf streamBuf(buffer);
+    std::istream iss(&streamBuf);
+    return readSTEP(iss);
+}
+
 val exportSTEP(const ShapeNode& root) {
     Handle(TDocStd_Document) doc = buildDocumentFromNode(root);
 
@@ -374,32 +1091,631 @@ val exportSTEP(const ShapeNode& root) {
     return toUint8Array(oss.str());
 }
 
+/**
+ * STEP 读取参数，JS 侧传入
+ * { metadata?: boolean, healing?: boolean, precisionMode?: "file" | "user", precision?: number }
+ * metadata 为 false 时使用 STEPControl_Reader 只转换几何，不建立 XCAF 文档，结果节点没有名称和颜色
+ * healing 为 false 时跳过转换后的 ShapeFix 处理，文件质量可靠时可明显缩短转换时间
+ * 指定 precision 且未指定 precisionMode 时按 "user" 处理
+ */
+struct StepReadOptions {
+    bool metadata = true;
+    bool healing = true;
+    DESTEP_Parameters params;
+
+    static StepReadOptions fromVal(const val& options) {
+        StepReadOptions result;
+        result.params.InitFromStatic();
+        if (options.isUndefined() || options.isNull()) {
+            return result;
+        }
+        val metadata = options["metadata"];
+        val healing = options["healing"];
+        val precisionMode = options["precisionMode"];
+        val precision = options["precision"];
+        if (!metadata.isUndefined()) result.metadata = metadata.as<bool>();
+        if (!healing.isUndefined()) result.healing = healing.as<bool>();
+        if (!precision.isUndefined()) {
+            result.params.ReadPrecisionVal = precision.as<double>();
+            result.params.ReadPrecisionMode = DESTEP_Parameters::ReadMode_Precision_User;
+        }
+        if (!precisionMode.isUndefined()) {
+            result.params.ReadPrecisionMode = precisionMode.as<std::string>() == "user"
+                ? DESTEP_Parameters::ReadMode_Precision_User
+                : DESTEP_Parameters::ReadMode_Precision_File;
+        }
+        return result;
+    }
 
-// ==================== IGES ====================
+    void apply(XSControl_Reader& reader) const {
+        if (!healing) {
+            // 显式设置空的操作集合，转换后不再执行默认的 ShapeFix 序列
+            reader.SetShapeProcessFlags(ShapeProcess::OperationsFlags());
+        }
+    }
+};
 
-std::optional<ShapeNode> importIGES(const Uint8Array& buffer) {
-    std::string tmpFile = "/tmp/temp_import.igs";
-    writeBufferToFile(tmpFile, buffer);
+/** 只转换几何的 STEP 导入，根节点下每个转换出的 shape 对应一个无名称子节点 */
+ImportResult readSTEPGeometry(const val& source, const val& options, const StepReadOptions& stepOptions) {
+    STEPControl_Reader reader;
+    stepOptions.apply(reader);
+    return readWithProgress<ImportResult>("stp", source, options,
+        [&reader, &stepOptions](std::istream& stream) {
+            return reader.ReadStream("stp", stepOptions.params, stream);
+        },
+        [&reader](const Message_ProgressRange& range) {
+            return reader.TransferRoots(range) > 0;
+        },
+        [&reader]() {
+            ShapeNode root { .shape = std::nullopt, .color = std::nullopt, .children = {}, .name = "" };
+            for (Standard_Integer i = 1; i <= reader.NbShapes(); i++) {
+                root.children.push_back(ShapeNode {
+                    .shape = reader.Shape(i),
+                    .color = std::nullopt,
+                    .children = {},
+                    .name = "",
+                });
+            }
+            return root;
+        });
+}
+
+/**
+ * @description: 带进度回调、取消和读取参数的 STEP 导入，结果中的 timings 为各阶段耗时（毫秒）
+ * @param {Uint8Array | HeapBuffer} source
+ * @param {val} options { onProgress?, cancelToken?, progressInterval? } 见 JSProgressIndicator，
+ *                      { metadata?, healing?, precisionMode?, precision? } 见 StepReadOptions
+ * @return {ImportResult}
+ */
+ImportResult importSTEPWithOptions(const val& source, const val& options) {
+    const StepReadOptions stepOptions = StepReadOptions::fromVal(options);
+    if (!stepOptions.metadata) {
+        return readSTEPGeometry(source, options, stepOptions);
+    }
+    STEPCAFControl_Reader reader;
+    stepOptions.apply(reader.ChangeReader());
+    return readDocumentWithProgress<ImportResult>(reader, "stp", source, options,
+        [&reader, &stepOptions](std::istream& stream) {
+            return reader.ReadStream("stp", stepOptions.params, stream);
+        },
+        parseDocumentToNode);
+}
+
+/**
+ * @description: 保留实例化的 STEP 导入，重复使用的零件只输出一个原型，前端可按原型划分一次网格后用 GPU 实例化渲染
+ * @param {Uint8Array | HeapBuffer} source
+ * @param {val} options 同 importSTEPWithOptions，metadata 不生效
+ * @return {InstancedImportResult}
+ */
+InstancedImportResult importSTEPInstanced(const val& source, const val& options) {
+    const StepReadOptions stepOptions = StepReadOptions::fromVal(options);
+    STEPCAFControl_Reader reader;
+    stepOptions.apply(reader.ChangeReader());
+    return readDocumentWithProgress<InstancedImportResult>(reader, "stp", source, options,
+        [&reader, &stepOptions](std::istream& stream) {
+            return reader.ReadStream("stp", stepOptions.params, stream);
+        },
+        documentToInstances);
+}
+
+/**
+ * @description: 以扁平列式结构导入 STEP，前端一次遍历数组即可建立场景图，不需要逐节点跨越 embind 边界
+ * @param {Uint8Array | HeapBuffer} source
+ * @param {val} options 同 importSTEPWithOptions，metadata 不生效
+ * @return {FlatImportResult} assembly.toObject() 中的数组为 wasm 堆视图，result 释放后失效
+ */
+FlatImportResult importSTEPFlat(const val& source, const val& options) {
+    const StepReadOptions stepOptions = StepReadOptions::fromVal(options);
+    STEPCAFControl_Reader reader;
+    stepOptions.apply(reader.ChangeReader());
+    return readDocumentWithProgress<FlatImportResult>(reader, "stp", source, options,
+        [&reader, &stepOptions](std::istream& stream) {
+            return reader.ReadStream("stp", stepOptions.params, stream);
+        },
+        documentToFlatAssembly);
+}
+
+XcafDocumentResult importSTEPDocument(const val& source, const val& options) {
+    const StepReadOptions stepOptions = StepReadOptions::fromVal(options);
+    STEPCAFControl_Reader reader;
+    stepOptions.apply(reader.ChangeReader());
+    return readDocumentWithProgress<XcafDocumentResult>(reader, "stp", source, options,
+        [&reader, &stepOptions](std::istream& stream) {
+            return reader.ReadStream("stp", stepOptions.params, stream);
+        },
+        [](const Handle(TDocStd_Document)& document) {
+            return XcafDocument(document);
+        });
+}
+
+template <typename Build>
+ExportResult writeSTEPWithProgress(const val& options, Build build) {
+    STEPCAFControl_Writer writer;
+    writer.SetColorMode(true);
+    writer.SetNameMode(true);
+    return writeWithProgress("stp", options, build,
+        [&writer](const Handle(TDocStd_Document)& document, const Message_ProgressRange& range) {
+            return writer.Transfer(document, STEPControl_AsIs, nullptr, range);
+        },
+        [&writer](std::ostream& stream) {
+            return writer.WriteStream(stream) == IFSelect_RetDone;
+        });
+}
+
+ExportResult exportSTEPWithOptions(const ShapeNode& root, const val& options) {
+    return writeSTEPWithProgress(options, [&root]() {
+        return buildDocumentFromNode(root);
+    });
+}
+
+/**
+ * @description: 按原型/实例结构导出 STEP，每个原型写为一个产品，每个实例写为带位置的组件引用
+ * @param {val} assembly importSTEPInstanced / importIGESInstanced 返回的 assembly 结构
+ * @param {val} options { name?: string } 根装配名称，其余同 exportSTEPWithOptions
+ * @return {ExportResult}
+ */
+ExportResult exportSTEPInstanced(const val& assembly, const val& options) {
+    return writeSTEPWithProgress(options, [&assembly, &options]() {
+        return buildDocumentFromInstances(assembly, getAssemblyName(options));
+    });
+}
+
+
+// ==================== STEP scan ====================
+
+/**
+ * STEP 产品结构中的一次出现，顶层产品的 occurrence 为空。
+ * 同一 ProductDefinition 被多次引用时每次引用各对应一个节点
+ */
+struct StepProductNode {
+    Handle(StepBasic_ProductDefinition) definition;
+    Handle(StepRepr_NextAssemblyUsageOccurrence) occurrence;
+    std::vector<StepProductNode> children;
+};
+
+std::string getProductName(const Handle(StepBasic_ProductDefinition)& definition) {
+    if (definition.IsNull() || definition->Formation().IsNull()) {
+        return std::string();
+    }
+    const Handle(StepBasic_Product)& product = definition->Formation()->OfProduct();
+    if (product.IsNull() || product->Name().IsNull()) {
+        return std::string();
+    }
+    return std::string(product->Name()->ToCString());
+}
+
+using StepUsageMap = NCollection_DataMap<Handle(Standard_Transient), std::vector<Handle(StepRepr_NextAssemblyUsageOccurrence)>>;
+
+void buildProductNode(StepProductNode& node, const StepUsageMap& usages, TColStd_MapOfTransient& ancestors) {
+    const std::vector<Handle(StepRepr_NextAssemblyUsageOccurrence)>* children = usages.Seek(node.definition);
+    if (children == nullptr || !ancestors.Add(node.definition)) {
+        return;
+    }
+    for (const Handle(StepRepr_NextAssemblyUsageOccurrence)& usage : *children) {
+        StepProductNode child { usage->RelatedProductDefinition(), usage, {} };
+        buildProductNode(child, usages, ancestors);
+        node.children.push_back(std::move(child));
+    }
+    ancestors.Remove(node.definition);
+}
+
+/**
+ * 按 NEXT_ASSEMBLY_USAGE_OCCURRENCE 建立产品树，未被任何 NAUO 引用的 ProductDefinition 作为顶层，
+ * 子节点按实体在文件中的顺序排列
+ */
+std::vector<StepProductNode> buildProductTree(const Handle(StepData_StepModel)& model) {
+    StepUsageMap usages;
+    TColStd_MapOfTransient usedDefinitions;
+    std::vector<Handle(StepBasic_ProductDefinition)> definitions;
+    for (Standard_Integer i = 1; i <= model->NbEntities(); i++) {
+        const Handle(Standard_Transient)& entity = model->Value(i);
+        if (entity->IsKind(STANDARD_TYPE(StepBasic_ProductDefinition))) {
+            definitions.push_back(Handle(StepBasic_ProductDefinition)::DownCast(entity));
+            continue;
+        }
+        Handle(StepRepr_NextAssemblyUsageOccurrence) usage = Handle(StepRepr_NextAssemblyUsageOccurrence)::DownCast(entity);
+        if (usage.IsNull() || usage->RelatingProductDefinition().IsNull() || usage->RelatedProductDefinition().IsNull()) {
+            continue;
+        }
+        if (!usages.IsBound(usage->RelatingProductDefinition())) {
+            usages.Bind(usage->RelatingProductDefinition(), {});
+        }
+        usages.ChangeFind(usage->RelatingProductDefinition()).push_back(usage);
+        usedDefinitions.Add(usage->RelatedProductDefinition());
+    }
+
+    std::vector<StepProductNode> roots;
+    TColStd_MapOfTransient ancestors;
+    for (const Handle(StepBasic_ProductDefinition)& definition : definitions) {
+        if (usedDefinitions.Contains(definition)) {
+            continue;
+        }
+        StepProductNode root { definition, Handle(StepRepr_NextAssemblyUsageOccurrence)(), {} };
+        buildProductNode(root, usages, ancestors);
+        roots.push_back(std::move(root));
+    }
+    return roots;
+}
+
+/**
+ * 产品自身形状表示引用的实体统计，只沿 SHAPE_DEFINITION_REPRESENTATION 和不带变换的
+ * SHAPE_REPRESENTATION_RELATIONSHIP 展开，不包含子装配
+ */
+struct StepProductStats {
+    int entityCount = 0;
+    bool hasBounds = false;
+    BoundingBox3 bounds;
+};
+
+class StepProductStatsCollector {
+public:
+    explicit StepProductStatsCollector(const Handle(StepData_StepModel)& model)
+        : shareTool(model) {
+        for (Standard_Integer i = 1; i <= model->NbEntities(); i++) {
+            const Handle(Standard_Transient)& entity = model->Value(i);
+            Handle(StepShape_ShapeDefinitionRepresentation) sdr = Handle(StepShape_ShapeDefinitionRepresentation)::DownCast(entity);
+            if (!sdr.IsNull()) {
+                addDefinitionRepresentation(sdr);
+                continue;
+            }
+            Handle(StepRepr_ShapeRepresentationRelationship) srr = Handle(StepRepr_ShapeRepresentationRelationship)::DownCast(entity);
+            if (!srr.IsNull() && !srr->IsKind(STANDARD_TYPE(StepRepr_RepresentationRelationshipWithTransformation))
+                && !srr->Rep1().IsNull() && !srr->Rep2().IsNull()) {
+                link(srr->Rep1(), srr->Rep2());
+                link(srr->Rep2(), srr->Rep1());
+            }
+        }
+    }
+
+    const StepProductStats& get(const Handle(StepBasic_ProductDefinition)& definition) {
+        if (const StepProductStats* cached = stats.Seek(definition)) {
+            return *cached;
+        }
+
+        TColStd_MapOfTransient visited;
+        TColStd_MapOfTransient counted;
+        std::vector<Handle(Standard_Transient)> pending;
+        if (const std::vector<Handle(Standard_Transient)>* reps = productReps.Seek(definition)) {
+            pending = *reps;
+        }
+        StepProductStats result;
+        double min[3] = { RealLast(), RealLast(), RealLast() };
+        double max[3] = { RealFirst(), RealFirst(), RealFirst() };
+        while (!pending.empty()) {
+            Handle(Standard_Transient) rep = pending.back();
+            pending.pop_back();
+            if (!visited.Add(rep)) {
+                continue;
+            }
+            if (const std::vector<Handle(Standard_Transient)>* linked = repLinks.Seek(rep)) {
+                pending.insert(pending.end(), linked->begin(), linked->end());
+            }
+            for (Interface_EntityIterator it = shareTool.All(rep); it.More(); it.Next()) {
+                const Handle(Standard_Transient)& entity = it.Value();
+                if (!counted.Add(entity)) {
+                    continue;
+                }
+                result.entityCount++;
+                Handle(StepGeom_CartesianPoint) point = Handle(StepGeom_CartesianPoint)::DownCast(entity);
+                if (point.IsNull() || point->NbCoordinates() != 3) {
+                    continue;
+                }
+                result.hasBounds = true;
+                for (Standard_Integer k = 0; k < 3; k++) {
+                    min[k] = std::min(min[k], point->CoordinatesValue(k + 1));
+                    max[k] = std::max(max[k], point->CoordinatesValue(k + 1));
+                }
+            }
+        }
+        if (result.hasBounds) {
+            result.bounds = BoundingBox3(Vector3(min[0], min[1], min[2]), Vector3(max[0], max[1], max[2]));
+        }
+        return *stats.Bound(definition, result);
+    }
+
+private:
+    void addDefinitionRepresentation(const Handle(StepShape_ShapeDefinitionRepresentation)& sdr) {
+        const Handle(StepRepr_PropertyDefinition) property = sdr->Definition().PropertyDefinition();
+        if (property.IsNull() || sdr->UsedRepresentation().IsNull()) {
+            return;
+        }
+        const Handle(StepBasic_ProductDefinition) definition = property->Definition().ProductDefinition();
+        if (definition.IsNull()) {
+            return;
+        }
+        if (!productReps.IsBound(definition)) {
+            productReps.Bind(definition, {});
+        }
+        productReps.ChangeFind(definition).push_back(sdr->UsedRepresentation());
+    }
+
+    void link(const Handle(Standard_Transient)& from, const Handle(Standard_Transient)& to) {
+        if (!repLinks.IsBound(from)) {
+            repLinks.Bind(from, {});
+        }
+        repLinks.ChangeFind(from).push_back(to);
+    }
+
+    using TransientListMap = NCollection_DataMap<Handle(Standard_Transient), std::vector<Handle(Standard_Transient)>>;
+
+    Interface_ShareTool shareTool;
+    TransientListMap productReps;
+    TransientListMap repLinks;
+    NCollection_DataMap<Handle(Standard_Transient), StepProductStats> stats;
+};
+
+val productNodeToObject(const StepProductNode& node, const std::string& path, StepProductStatsCollector& collector,
+    double bytesPerEntity) {
+    const StepProductStats& stats = collector.get(node.definition);
+    val obj = val::object();
+    obj.set("name", getProductName(node.definition));
+    obj.set("path", path);
+    obj.set("entityCount", stats.entityCount);
+    obj.set("estimatedSize", std::round(stats.entityCount * bytesPerEntity));
+    if (stats.hasBounds && node.children.empty()) {
+        obj.set("bounds", stats.bounds);
+    }
+    val children = val::array();
+    for (size_t i = 0; i < node.children.size(); i++) {
+        children.call<void>("push", productNodeToObject(node.children[i], path + "/" + std::to_string(i), collector,
+            bytesPerEntity));
+    }
+    obj.set("children", children);
+    return obj;
+}
+
+/**
+ * @description: 只解析 STEP 模型、不转换几何，返回产品结构用于选择性导入前的预览
+ * 节点 { name, path, entityCount, estimatedSize, bounds?, children }，path 为各级子节点序号（如 "0/2/1"），可传给 importSTEPProducts。
+ * entityCount 为产品自身形状表示引用的实体数；estimatedSize 为这些实体在文件中大约占用的字节数，
+ * 按 entityCount × 文件平均每实体字节数（byteSize / entityCount）估算，只用于比较各产品的相对规模；
+ * bounds 取零件形状中 CARTESIAN_POINT 的范围（文件单位、零件自身坐标系，包含控制点，偏保守），装配节点不提供
+ * @param {Uint8Array | HeapBuffer} source
+ * @return {{ status, message, entityCount, byteSize, productCount, roots } }
+ */
+val scanSTEP(const val& source) {
+    STEPControl_Reader reader;
+    SourceStream input(source);
+    const IFSelect_ReturnStatus readStatus = reader.ReadStream("stp", input.get());
+    input.release();
+
+    val result = val::object();
+    if (readStatus != IFSelect_RetDone) {
+        result.set("status", false);
+        result.set("message", std::string("parse failed"));
+        return result;
+    }
+
+    const Handle(StepData_StepModel) model = reader.StepModel();
+    std::vector<StepProductNode> roots = buildProductTree(model);
+    StepProductStatsCollector collector(model);
+    const double bytesPerEntity = model->NbEntities() > 0
+        ? static_cast<double>(input.size()) / model->NbEntities() : 0.0;
+    val rootArray = val::array();
+    for (size_t i = 0; i < roots.size(); i++) {
+        rootArray.call<void>("push", productNodeToObject(roots[i], std::to_string(i), collector, bytesPerEntity));
+    }
+
+    Standard_Integer productCount = 0;
+    for (Standard_Integer i = 1; i <= model->NbEntities(); i++) {
+        if (model->Value(i)->IsKind(STANDARD_TYPE(StepBasic_ProductDefinition))) {
+            productCount++;
+        }
+    }
+    result.set("status", true);
+    result.set("message", std::string());
+    result.set("entityCount", model->NbEntities());
+    result.set("byteSize", static_cast<double>(input.size()));
+    result.set("productCount", productCount);
+    result.set("roots", rootArray);
+    return result;
+}
+
+// ==================== STEP selective import ====================
+
+/**
+ * 按路径查找产品节点，路径以 "/" 分隔，每段为子节点序号或产品名称（取第一个同名节点），序号优先
+ */
+const StepProductNode* findProductNode(const std::vector<StepProductNode>& roots, const std::string& path) {
+    const std::vector<StepProductNode>* level = &roots;
+    const StepProductNode* node = nullptr;
+    std::istringstream segments(path);
+    std::string segment;
+    while (std::getline(segments, segment, '/')) {
+        if (segment.empty()) {
+            continue;
+        }
+        node = nullptr;
+        // 不抛异常地解析序号，超出 size_t 的纯数字段（如零件号 "5000000001"）按名称匹配
+        size_t index = 0;
+        const char* end = segment.data() + segment.size();
+        const std::from_chars_result parsed = std::from_chars(segment.data(), end, index);
+        if (parsed.ec == std::errc() && parsed.ptr == end && index < level->size()) {
+            node = &(*level)[index];
+        }
+        for (size_t i = 0; node == nullptr && i < level->size(); i++) {
+            if (getProductName((*level)[i].definition) == segment) {
+                node = &(*level)[i];
+            }
+        }
+        if (node == nullptr) {
+            return nullptr;
+        }
+        level = &node->children;
+    }
+    return node;
+}
+
+/**
+ * STEP 样式中的表面颜色，按被着色表示项转换结果的 TShape 索引
+ */
+std::unordered_map<const TopoDS_TShape*, std::string> collectStyleColors(const Handle(XSControl_WorkSession)& workSession,
+    const Handle(Transfer_TransientProcess)& transientProcess) {
+    std::unordered_map<const TopoDS_TShape*, std::string> colors;
+    STEPConstruct_Styles styles(workSession);
+    if (!styles.LoadStyles()) {
+        return colors;
+    }
+    for (Standard_Integer i = 1; i <= styles.NbStyles(); i++) {
+        Handle(StepVisual_StyledItem) style = styles.Style(i);
+        Handle(StepVisual_Colour) surfaceColour, boundaryColour, curveColour, renderColour;
+        Standard_Real transparency = 0.0;
+        Standard_Boolean isComponent = Standard_False;
+        if (style.IsNull() || !styles.GetColors(style, surfaceColour, boundaryColour, curveColour, renderColour,
+                transparency, isComponent)) {
+            continue;
+        }
+        const Handle(StepVisual_Colour)& colour = !surfaceColour.IsNull() ? surfaceColour : curveColour;
+        Quantity_Color color;
+        if (colour.IsNull() || !styles.DecodeColor(colour, color)) {
+            continue;
+        }
+        TopoDS_Shape shape = TransferBRep::ShapeResult(transientProcess, style->Item());
+        if (!shape.IsNull()) {
+            colors.emplace(shape.TShape().get(), std::string(Quantity_Color::ColorToHex(color).ToCString()));
+        }
+    }
+    return colors;
+}
+
+std::optional<std::string> findShapeColor(const TopoDS_Shape& shape,
+    const std::unordered_map<const TopoDS_TShape*, std::string>& colors) {
+    auto found = colors.find(shape.TShape().get());
+    if (found != colors.end()) {
+        return found->second;
+    }
+    for (TopoDS_Iterator it(shape); it.More(); it.Next()) {
+        found = colors.find(it.Value().TShape().get());
+        if (found != colors.end()) {
+            return found->second;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * 将已转换的产品子树转换为 ShapeNode，parentLocation 为父节点相对所选子树根的累计位置。
+ * 节点位置取 NAUO 的转换结果，所选子树的根没有经过 NAUO 转换，位于其自身坐标系
+ */
+ShapeNode productToShapeNode(const StepProductNode& node, const TopLoc_Location& parentLocation,
+    const Handle(Transfer_TransientProcess)& transientProcess,
+    const std::unordered_map<const TopoDS_TShape*, std::string>& colors) {
+    const TopoDS_Shape occurrence = node.occurrence.IsNull()
+        ? TopoDS_Shape() : TransferBRep::ShapeResult(transientProcess, node.occurrence);
+    const TopLoc_Location location = occurrence.IsNull() ? parentLocation : parentLocation * occurrence.Location();
+
+    ShapeNode result {
+        .shape = std::nullopt,
+        .color = std::nullopt,
+        .children = {},
+        .name = getProductName(node.definition),
+    };
+    if (node.children.empty()) {
+        TopoDS_Shape shape = TransferBRep::ShapeResult(transientProcess, node.definition);
+        if (!shape.IsNull()) {
+            shape = shape.Moved(location);
+        } else if (!occurrence.IsNull()) {
+            shape = occurrence.Moved(parentLocation);
+        }
+        if (!shape.IsNull()) {
+            result.color = findShapeColor(shape, colors);
+            result.shape = shape;
+        }
+        return result;
+    }
+    for (const StepProductNode& child : node.children) {
+        result.children.push_back(productToShapeNode(child, location, transientProcess, colors));
+    }
+    return result;
+}
+
+/**
+ * @description: 只转换 STEP 中指定的子装配或零件，结果保留产品名称和表面颜色。
+ * 文件仍需完整解析，但几何转换只针对所选产品及其后代，每个所选子树位于其根产品自身的坐标系
+ * @param {Uint8Array | HeapBuffer} source
+ * @param {string[]} paths scanSTEP 返回的 path（如 "0/2/1"），也可用产品名称路径（如 "Plant/Line A/Module 3"）
+ * @param {val} options 同 importSTEPWithOptions，metadata 不生效
+ * @return {ImportResult} 根节点下每个 path 对应一个子节点，任一 path 不存在时 status 为 false
+ */
+ImportResult importSTEPProducts(const val& source, const val& paths, const val& options) {
+    const StepReadOptions stepOptions = StepReadOptions::fromVal(options);
+    const std::vector<std::string> productPaths = vecFromJSArray<std::string>(paths);
+    STEPControl_Reader reader;
+    stepOptions.apply(reader);
+
+    std::vector<StepProductNode> roots;
+    std::vector<const StepProductNode*> selected;
+    return readWithProgress<ImportResult>("stp", source, options,
+        [&reader, &stepOptions](std::istream& stream) {
+            return reader.ReadStream("stp", stepOptions.params, stream);
+        },
+        [&](const Message_ProgressRange& range) {
+            roots = buildProductTree(reader.StepModel());
+            for (const std::string& path : productPaths) {
+                const StepProductNode* node = findProductNode(roots, path);
+                if (node == nullptr) {
+                    return false;
+                }
+                selected.push_back(node);
+            }
+            Message_ProgressScope scope(range, "products", static_cast<Standard_Real>(selected.size()));
+            for (const StepProductNode* node : selected) {
+                if (!scope.More()) {
+                    return false;
+                }
+                reader.TransferEntity(node->definition, scope.Next());
+            }
+            return true;
+        },
+        [&]() {
+            const Handle(XSControl_WorkSession)& workSession = reader.WS();
+            const Handle(Transfer_TransientProcess) transientProcess = workSession->TransferReader()->TransientProcess();
+            const auto colors = collectStyleColors(workSession, transientProcess);
+            ShapeNode root { .shape = std::nullopt, .color = std::nullopt, .children = {}, .name = "" };
+            for (const StepProductNode* node : selected) {
+                root.children.push_back(productToShapeNode(*node, TopLoc_Location(), transientProcess, colors));
+            }
+            return root;
+        });
+}
+
+// ==================== IGES ====================
 
+std::optional<ShapeNode> readIGES(std::istream& iss) {
     IGESCAFControl_Reader reader;
     reader.SetColorMode(true);
     reader.SetNameMode(true);
-    if (reader.ReadFile(tmpFile.c_str()) != IFSelect_RetDone) {
-        std::remove(tmpFile.c_str());
+    if (reader.ReadStream("igs", iss) != IFSelect_RetDone) {
         return std::nullopt;
     }
 
     Handle(TDocStd_Document) document = new TDocStd_Document("MDTV-XCAF");
     XCAFDoc_DocumentTool::Set(document->Main());
     if (!reader.Transfer(document)) {
-        std::remove(tmpFile.c_str());
         return std::nullopt;
     }
 
-    std::remove(tmpFile.c_str());
     return parseDocumentToNode(document);
 }
 
+std::optional<ShapeNode> importIGES(const Uint8Array& buffer) {
+    std::vector<uint8_t> input = uint8ArrayToVector(buffer);
+    VectorBuffer vectorBuffer(input);
+    std::istream iss(&vectorBuffer);
+    return readIGES(iss);
+}
+
+/**
+ * @description: 从 HeapBuffer 导入 IGES，与 importSTEPFromBuffer 相同不经过 MEMFS
+ * @param {HeapBuffer&} buffer JS 已写入的文件数据，导入后可调用 clear() 释放
+ * @return {ShapeNode | undefined}
+ */
+std::optional<ShapeNode> importIGESFromBuffer(const HeapBuffer& buffer) {
+    HeapBufferStreamBuf streamBuf(buffer);
+    std::istream iss(&streamBuf);
+    return readIGES(iss);
+}
+
 val exportIGES(const ShapeNode& root) {
     Handle(TDocStd_Document) doc = buildDocumentFromNode(root);
 
@@ -418,6 +1734,74 @@ val exportIGES(const ShapeNode& root) {
     return toUint8Array(oss.str());
 }
 
+ImportResult importIGESWithOptions(const val& source, const val& options) {
+    IGESCAFControl_Reader reader;
+    return readDocumentWithProgress<ImportResult>(reader, "igs", source, options,
+        [&reader](std::istream& stream) {
+            return reader.ReadStream("igs", stream);
+        },
+        parseDocumentToNode);
+}
+
+InstancedImportResult importIGESInstanced(const val& source, const val& options) {
+    IGESCAFControl_Reader reader;
+    return readDocumentWithProgress<InstancedImportResult>(reader, "igs", source, options,
+        [&reader](std::istream& stream) {
+            return reader.ReadStream("igs", stream);
+        },
+        documentToInstances);
+}
+
+FlatImportResult importIGESFlat(const val& source, const val& options) {
+    IGESCAFControl_Reader reader;
+    return readDocumentWithProgress<FlatImportResult>(reader, "igs", source, options,
+        [&reader](std::istream& stream) {
+            return reader.ReadStream("igs", stream);
+        },
+        documentToFlatAssembly);
+}
+
+XcafDocumentResult importIGESDocument(const val& source, const val& options) {
+    IGESCAFControl_Reader reader;
+    return readDocumentWithProgress<XcafDocumentResult>(reader, "igs", source, options,
+        [&reader](std::istream& stream) {
+            return reader.ReadStream("igs", stream);
+        },
+        [](const Handle(TDocStd_Document)& document) {
+            return XcafDocument(document);
+        });
+}
+
+template <typename Build>
+ExportResult writeIGESWithProgress(const val& options, Build build) {
+    IGESCAFControl_Writer writer;
+    writer.SetColorMode(true);
+    writer.SetNameMode(true);
+    return writeWithProgress("igs", options, build,
+        [&writer](const Handle(TDocStd_Document)& document, const Message_ProgressRange& range) {
+            if (!writer.Transfer(document, range)) {
+                return false;
+            }
+            writer.ComputeModel();
+            return true;
+        },
+        [&writer](std::ostream& stream) {
+            return static_cast<bool>(writer.Write(stream));
+        });
+}
+
+ExportResult exportIGESWithOptions(const ShapeNode& root, const val& options) {
+    return writeIGESWithProgress(options, [&root]() {
+        return buildDocumentFromNode(root);
+    });
+}
+
+ExportResult exportIGESInstanced(const val& assembly, const val& options) {
+    return writeIGESWithProgress(options, [&assembly, &options]() {
+        return buildDocumentFromInstances(assembly, getAssemblyName(options));
+    });
+}
+
 
 // ==================== STL ====================
 
@@ -441,47 +1825,450 @@ std::optional<ShapeNode> importSTL(const Uint8Array& buffer) {
     };
 }
 
-val exportSTL(const TopoShapeArray& input, double linearDeflection, double angularDeflection) {
-    TopoDS_Compound compound = Compound::fromShapes(input);
+void writeFloat(uint8_t*& cursor, double value) {
+    const float f = static_cast<float>(value);
+    std::memcpy(cursor, &f, sizeof(float));
+    cursor += sizeof(float);
+}
 
-    BRepMesh_IncrementalMesh mesh(compound, linearDeflection, Standard_False, angularDeflection);
-    mesh.Perform();
+/**
+ * @description: 导出二进制 STL，直接使用 shape 上已有的三角化写入预分配的缓冲，
+ * 只对缺少三角化的面执行网格划分，面的位置变换与朝向均会应用
+ * @param {TopoShapeArray&} input
+ * @param {double} linearDeflection 缺少三角化时使用的线性偏差
+ * @param {double} angularDeflection 缺少三角化时使用的角度偏差
+ * @return {Uint8Array | null}
+ */
+val exportSTL(const TopoShapeArray& input, double linearDeflection, double angularDeflection) {
+    std::vector<TopoDS_Shape> shapes = vecFromJSArray<TopoDS_Shape>(input);
+
+    // 只收集缺少三角化的面，合并为一次划分，已有三角化的面保持不变
+    std::vector<TopoDS_Shape> pending;
+    for (const TopoDS_Shape& shape : shapes) {
+        for (const TopoDS_Face& face : Shape::getFaces(shape)) {
+            TopLoc_Location loc;
+            if (BRep_Tool::Triangulation(face, loc).IsNull()) {
+                pending.push_back(face);
+            }
+        }
+    }
+    if (!pending.empty()) {
+        MeshCache::ensureTriangulation(pending, MeshOptions(linearDeflection, angularDeflection));
+    }
 
-    std::string tmpFile = "/tmp/temp_export.stl";
-    StlAPI_Writer writer;
-    writer.ASCIIMode() = Standard_False;
-    if (!writer.Write(compound, tmpFile.c_str())) {
+    std::vector<TopoDS_Face> faces;
+    size_t nbTriangles = 0;
+    for (const TopoDS_Shape& shape : shapes) {
+        for (const TopoDS_Face& face : Shape::getFaces(shape)) {
+            TopLoc_Location loc;
+            const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, loc);
+            if (triangulation.IsNull()) {
+                continue;
+            }
+            nbTriangles += triangulation->NbTriangles();
+            faces.push_back(face);
+        }
+    }
+    if (nbTriangles > UINT32_MAX) {
         return val::null();
     }
 
-    std::ifstream file(tmpFile, std::ios::binary);
-    std::string content((std::istreambuf_iterator<char>(file)),
-                         std::istreambuf_iterator<char>());
-    file.close();
-    std::remove(tmpFile.c_str());
-    return toUint8Array(content);
+    // 80 字节文件头 + 4 字节三角形数 + 每个三角形 50 字节
+    std::vector<uint8_t> output(84 + nbTriangles * 50, 0);
+    const char header[] = "Binary STL";
+    std::memcpy(output.data(), header, sizeof(header) - 1);
+    const uint32_t count = static_cast<uint32_t>(nbTriangles);
+    std::memcpy(output.data() + 80, &count, sizeof(count));
+
+    uint8_t* cursor = output.data() + 84;
+    for (const TopoDS_Face& face : faces) {
+        TopLoc_Location loc;
+        const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, loc);
+        const gp_Trsf& trsf = loc.Transformation();
+        const bool isMirrored = trsf.VectorialPart().Determinant() < 0;
+        const bool isFlipped = (face.Orientation() == TopAbs_REVERSED) ^ isMirrored;
+
+        for (Standard_Integer i = 1; i <= triangulation->NbTriangles(); i++) {
+            Standard_Integer n1, n2, n3;
+            triangulation->Triangle(i).Get(n1, n2, n3);
+            if (isFlipped) {
+                std::swap(n2, n3);
+            }
+            gp_Pnt p1 = triangulation->Node(n1);
+            gp_Pnt p2 = triangulation->Node(n2);
+            gp_Pnt p3 = triangulation->Node(n3);
+            if (!loc.IsIdentity()) {
+                p1.Transform(trsf);
+                p2.Transform(trsf);
+                p3.Transform(trsf);
+            }
+
+            gp_XYZ normal = (p2.XYZ() - p1.XYZ()).Crossed(p3.XYZ() - p1.XYZ());
+            const double length = normal.Modulus();
+            if (length > 0.0) {
+                normal /= length;
+            }
+            for (const gp_XYZ& xyz : { normal, p1.XYZ(), p2.XYZ(), p3.XYZ() }) {
+                writeFloat(cursor, xyz.X());
+                writeFloat(cursor, xyz.Y());
+                writeFloat(cursor, xyz.Z());
+            }
+            // 属性字节数保持为 0
+            cursor += 2;
+        }
+    }
+    return copyToTypedArray(output);
+}
+
+/**
+ * 收集 RWStl_Reader 输出的节点和三角形，节点已由读取器按位置焊接
+ */
+class StlMeshReader : public RWStl_Reader {
+public:
+    Standard_Integer AddNode(const gp_XYZ& point) override {
+        nodes.push_back(point);
+        return static_cast<Standard_Integer>(nodes.size());
+    }
+
+    void AddTriangle(Standard_Integer n1, Standard_Integer n2, Standard_Integer n3) override {
+        triangles.emplace_back(n1, n2, n3);
+    }
+
+    Handle(Poly_Triangulation) getTriangulation() const {
+        if (nodes.empty() || triangles.empty()) {
+            return Handle(Poly_Triangulation)();
+        }
+        Handle(Poly_Triangulation) triangulation = new Poly_Triangulation(
+            static_cast<Standard_Integer>(nodes.size()), static_cast<Standard_Integer>(triangles.size()), Standard_False);
+        for (size_t i = 0; i < nodes.size(); i++) {
+            triangulation->SetNode(static_cast<Standard_Integer>(i + 1), gp_Pnt(nodes[i]));
+        }
+        for (size_t i = 0; i < triangles.size(); i++) {
+            triangulation->SetTriangle(static_cast<Standard_Integer>(i + 1), triangles[i]);
+        }
+        return triangulation;
+    }
+
+private:
+    std::vector<gp_XYZ> nodes;
+    std::vector<Poly_Triangle> triangles;
+};
+
+/**
+ * @description: 读取二进制或 ASCII STL 为单个带 Poly_Triangulation 的面，流需支持 seek
+ * @return {TopoDS_Face} 失败时为空
+ */
+TopoDS_Face readSTLMesh(std::istream& stream) {
+    Handle(StlMeshReader) reader = new StlMeshReader();
+
+    stream.seekg(0, std::ios::end);
+    const std::streampos end = stream.tellg();
+    stream.seekg(0, std::ios::beg);
+
+    // 与 RWStl_Reader::Read 相同，ASCII 文件可能包含多个 solid
+    const bool isAscii = reader->IsAscii(stream, true);
+    Standard_ReadLineBuffer lineBuffer(1024);
+    while (stream.good()) {
+        const Standard_Boolean isRead = isAscii
+            ? reader->ReadAscii(stream, lineBuffer, end, Message_ProgressRange())
+            : reader->ReadBinary(stream, Message_ProgressRange());
+        if (!isRead) {
+            break;
+        }
+        stream >> std::ws;
+    }
+
+    Handle(Poly_Triangulation) triangulation = reader->getTriangulation();
+    if (triangulation.IsNull()) {
+        return TopoDS_Face();
+    }
+
+    TopoDS_Face face;
+    BRep_Builder builder;
+    builder.MakeFace(face, triangulation);
+    return face;
+}
+
+std::optional<ShapeNode> toSTLMeshNode(const TopoDS_Face& face) {
+    if (face.IsNull()) {
+        return std::nullopt;
+    }
+    return ShapeNode {
+        .shape = face,
+        .color = std::nullopt,
+        .children = {},
+        .name = "STL Mesh",
+    };
+}
+
+/**
+ * @description: 以网格形式导入 STL，结果为单个无曲面、带焊接后 Poly_Triangulation 的面，
+ * 可直接用于 toBRepResult、Mesher 和 exportSTL，避免每个三角形生成一个 B-Rep 面
+ * @param {Uint8Array&} buffer 二进制或 ASCII STL
+ * @return {ShapeNode | undefined}
+ */
+std::optional<ShapeNode> importSTLMesh(const Uint8Array& buffer) {
+    std::vector<uint8_t> input = uint8ArrayToVector(buffer);
+    VectorBuffer vectorBuffer(input);
+    std::istream iss(&vectorBuffer);
+    return toSTLMeshNode(readSTLMesh(iss));
+}
+
+std::optional<ShapeNode> importSTLMeshFromBuffer(const HeapBuffer& buffer) {
+    HeapBufferStreamBuf streamBuf(buffer);
+    std::istream iss(&streamBuf);
+    return toSTLMeshNode(readSTLMesh(iss));
 }
 
 // ==================== BRep ====================
 
+void computeMissingNormals(const TopoDS_Shape& shape) {
+    for (const TopoDS_Face& face : Shape::getFaces(shape)) {
+        TopLoc_Location loc;
+        const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, loc);
+        if (!triangulation.IsNull() && !triangulation->HasNormals()) {
+            BRepLib_ToolTriangulatedShape::ComputeNormals(face, triangulation);
+        }
+    }
+}
+
 val exportBREP(const TopoShapeArray& input) {
     TopoDS_Compound compound = Compound::fromShapes(input);
     std::ostringstream oss;
-    BRepTools::Write(compound, oss);
+    BRepTools::Write(compound, oss, Standard_True, Standard_False, TopTools_FormatVersion_CURRENT);
     return toUint8Array(oss.str());
 }
 
-TopoDS_Shape importBREP(const Uint8Array& buffer) {
-    std::string data = fromUint8Array(buffer);
-    std::istringstream iss(data);
+/**
+ * @description: 导出 BinTools 二进制 BREP，体积与解析耗时均明显小于文本格式
+ * @param {TopoShapeArray&} input
+ * @param {BRepWriteOptions} options
+ * @return {Uint8Array}
+ */
+val exportBREPBinary(const TopoShapeArray& input, const val& options) {
+    TopoDS_Compound compound = Compound::fromShapes(input);
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+    BRepWriteOptions::fromVal(options).write(compound, oss);
+    return toUint8Array(oss.str());
+}
+
+/** 按文件头自动识别二进制（BinTools）或文本（BRepTools）格式 */
+TopoDS_Shape readBREP(std::istream& iss) {
+    static const std::string binaryHeader = "Open CASCADE Topology";
+    std::string header(binaryHeader.size(), '\0');
+    iss.read(&header[0], static_cast<std::streamsize>(header.size()));
+    const bool isBinary = iss.gcount() == static_cast<std::streamsize>(header.size()) && header == binaryHeader;
+    iss.clear();
+    iss.seekg(0, std::ios::beg);
+
     TopoDS_Shape output;
-    BRep_Builder builder;
-    BRepTools::Read(output, iss, builder);
+    if (isBinary) {
+        BinTools::Read(output, iss);
+    } else {
+        BRep_Builder builder;
+        BRepTools::Read(output, iss, builder);
+    }
     return output;
 }
 
+TopoDS_Shape importBREP(const Uint8Array& buffer) {
+    std::vector<uint8_t> input = uint8ArrayToVector(buffer);
+    VectorBuffer vectorBuffer(input);
+    std::istream iss(&vectorBuffer);
+    return readBREP(iss);
+}
+
+TopoDS_Shape importBREPFromBuffer(const HeapBuffer& buffer) {
+    HeapBufferStreamBuf streamBuf(buffer);
+    std::istream iss(&streamBuf);
+    return readBREP(iss);
+}
+
 } // anonymous namespace
 
+BRepWriteOptions BRepWriteOptions::fromVal(const val& options) {
+    BRepWriteOptions result;
+    if (options.isUndefined() || options.isNull()) {
+        return result;
+    }
+    val withTriangulation = options["withTriangulation"];
+    val withNormals = options["withNormals"];
+    if (!withTriangulation.isUndefined()) result.withTriangulation = withTriangulation.as<bool>();
+    if (!withNormals.isUndefined()) result.withNormals = withNormals.as<bool>();
+    return result;
+}
+
+void BRepWriteOptions::write(const TopoDS_Shape& shape, std::ostream& stream) const {
+    if (withTriangulation && withNormals) {
+        computeMissingNormals(shape);
+    }
+    BinTools::Write(shape, stream, withTriangulation, withNormals, BinTools_FormatVersion_CURRENT);
+}
+
+// ==================== XcafDocument ====================
+
+namespace {
+
+std::string labelEntry(const TDF_Label& label) {
+    TCollection_AsciiString entry;
+    TDF_Tool::Entry(label, entry);
+    return std::string(entry.ToCString());
+}
+
+val labelToTreeObject(const TDF_Label& occurrence, const TDF_Label& label,
+    const Handle(XCAFDoc_ShapeTool)& shapeTool, const Handle(XCAFDoc_ColorTool)& colorTool) {
+    std::string name = getLabelNameNoRef(occurrence);
+    if (name.empty()) {
+        name = getLabelNameNoRef(label);
+    }
+    val obj = val::object();
+    obj.set("entry", labelEntry(occurrence));
+    obj.set("part", labelEntry(label));
+    obj.set("name", name);
+    std::string color;
+    if (getLabelColor(occurrence, shapeTool, colorTool, color)) {
+        obj.set("color", color);
+    }
+
+    const bool isAssembly = XCAFDoc_ShapeTool::IsAssembly(label);
+    obj.set("isAssembly", isAssembly);
+    val children = val::array();
+    if (isAssembly) {
+        TDF_LabelSequence components;
+        XCAFDoc_ShapeTool::GetComponents(label, components);
+        for (const TDF_Label& component : components) {
+            TDF_Label referred;
+            if (XCAFDoc_ShapeTool::GetReferredShape(component, referred)) {
+                children.call<void>("push", labelToTreeObject(component, referred, shapeTool, colorTool));
+            }
+        }
+    }
+    obj.set("children", children);
+    return obj;
+}
+
+} // anonymous namespace
+
+/** 文档与修改计数、导出缓存放在一起，由所有副本共享 */
+struct XcafDocument::State {
+    Handle(TDocStd_Document) document;
+    bool needsUpdate = false;
+    uint32_t revision = 1;
+    uint32_t stepRevision = 0;
+    uint32_t igesRevision = 0;
+    val stepCache = val::null();
+    val igesCache = val::null();
+};
+
+XcafDocument::XcafDocument(const Handle(TDocStd_Document)& document)
+    : state(std::make_shared<State>()) {
+    state->document = document;
+}
+
+XcafDocument XcafDocument::fromNode(const ShapeNode& root) {
+    return XcafDocument(buildDocumentFromNode(root));
+}
+
+val XcafDocument::getTree() const {
+    Handle(XCAFDoc_ShapeTool) shapeTool = XCAFDoc_DocumentTool::ShapeTool(state->document->Main());
+    Handle(XCAFDoc_ColorTool) colorTool = XCAFDoc_DocumentTool::ColorTool(state->document->Main());
+    TDF_LabelSequence freeShapes;
+    shapeTool->GetFreeShapes(freeShapes);
+    val roots = val::array();
+    for (const TDF_Label& label : freeShapes) {
+        roots.call<void>("push", labelToTreeObject(label, label, shapeTool, colorTool));
+    }
+    return roots;
+}
+
+ShapeNode XcafDocument::toNode() const {
+    return parseDocumentToNode(state->document);
+}
+
+TDF_Label XcafDocument::findLabel(const std::string& entry) const {
+    TDF_Label label;
+    TDF_Tool::Label(state->document->Main().Data(), entry.c_str(), label, Standard_False);
+    return label;
+}
+
+bool XcafDocument::setName(const std::string& entry, const std::string& name) {
+    TDF_Label label = findLabel(entry);
+    if (label.IsNull()) {
+        return false;
+    }
+    TDataStd_Name::Set(label, TCollection_ExtendedString(name.c_str(), Standard_True));
+    state->revision++;
+    return true;
+}
+
+bool XcafDocument::setColor(const std::string& entry, const val& color) {
+    TDF_Label label = findLabel(entry);
+    if (label.IsNull()) {
+        return false;
+    }
+    Handle(XCAFDoc_ColorTool) colorTool = XCAFDoc_DocumentTool::ColorTool(state->document->Main());
+    if (color.isUndefined() || color.isNull()) {
+        colorTool->UnSetColor(label, XCAFDoc_ColorSurf);
+    } else {
+        colorTool->SetColor(label, parseHexColor(color.as<std::string>()), XCAFDoc_ColorSurf);
+    }
+    state->revision++;
+    return true;
+}
+
+bool XcafDocument::replaceShape(const std::string& entry, const TopoDS_Shape& shape) {
+    TDF_Label label = findLabel(entry);
+    if (label.IsNull() || shape.IsNull()) {
+        return false;
+    }
+    if (XCAFDoc_ShapeTool::IsReference(label)) {
+        TDF_Label referred;
+        XCAFDoc_ShapeTool::GetReferredShape(label, referred);
+        label = referred;
+    }
+    if (!XCAFDoc_ShapeTool::IsSimpleShape(label)) {
+        return false;
+    }
+    // SetShape 对带位置的 shape 不做任何修改，零件只保存几何，实例位置在组件上
+    XCAFDoc_DocumentTool::ShapeTool(state->document->Main())->SetShape(label, shape.Located(TopLoc_Location()));
+    state->needsUpdate = true;
+    state->revision++;
+    return true;
+}
+
+void XcafDocument::prepareExport() {
+    if (state->needsUpdate) {
+        XCAFDoc_DocumentTool::ShapeTool(state->document->Main())->UpdateAssemblies();
+        state->needsUpdate = false;
+    }
+}
+
+ExportResult XcafDocument::exportSTEP(const val& options) {
+    if (state->stepRevision != state->revision) {
+        prepareExport();
+        ExportResult result = writeSTEPWithProgress(options, [this]() { return state->document; });
+        if (!result.status) {
+            return result;
+        }
+        state->stepCache = result.data;
+        state->stepRevision = state->revision;
+    }
+    return ExportResult(state->stepCache.call<val>("slice"), true, "");
+}
+
+ExportResult XcafDocument::exportIGES(const val& options) {
+    if (state->igesRevision != state->revision) {
+        prepareExport();
+        ExportResult result = writeIGESWithProgress(options, [this]() { return state->document; });
+        if (!result.status) {
+            return result;
+        }
+        state->igesCache = result.data;
+        state->igesRevision = state->revision;
+    }
+    return ExportResult(state->igesCache.call<val>("slice"), true, "");
+}
+
 namespace ExchangeBindings {
 
 struct Exchange {};
@@ -497,15 +2284,90 @@ void registerBindings() {
         .property("name", &ShapeNode::name)
         .function("getChildren", &ShapeNode::getChildren);
 
+    value_object<ImportTimings>("ImportTimings")
+        .field("parse", &ImportTimings::parse)
+        .field("transfer", &ImportTimings::transfer)
+        .field("tree", &ImportTimings::tree);
+
+    class_<ImportResult>("ImportResult")
+        .property("node", &ImportResult::node)
+        .property("timings", &ImportResult::timings)
+        .property("status", &ImportResult::status)
+        .property("message", &ImportResult::message);
+
+    class_<InstancedImportResult>("InstancedImportResult")
+        .property("assembly", &InstancedImportResult::assembly)
+        .property("timings", &InstancedImportResult::timings)
+        .property("status", &InstancedImportResult::status)
+        .property("message", &InstancedImportResult::message);
+
+    class_<FlatAssembly>("FlatAssembly")
+        .function("toObject", &flatAssemblyToObject)
+        .function("getNodeCount", optional_override([](const FlatAssembly& self) {
+            return self.parentIndex.size();
+        }))
+        .function("getShapeCount", optional_override([](const FlatAssembly& self) {
+            return self.shapes.size();
+        }));
+
+    class_<FlatImportResult>("FlatImportResult")
+        .property("assembly", &FlatImportResult::assembly, return_value_policy::reference())
+        .property("timings", &FlatImportResult::timings)
+        .property("status", &FlatImportResult::status)
+        .property("message", &FlatImportResult::message);
+
+    register_optional<XcafDocument>();
+
+    class_<XcafDocument>("XcafDocument")
+        .class_function("fromNode", &XcafDocument::fromNode)
+        .class_function("importSTEP", &importSTEPDocument)
+        .class_function("importIGES", &importIGESDocument)
+        .function("getTree", &XcafDocument::getTree)
+        .function("toNode", &XcafDocument::toNode)
+        .function("setName", &XcafDocument::setName)
+        .function("setColor", &XcafDocument::setColor)
+        .function("replaceShape", &XcafDocument::replaceShape)
+        .function("exportSTEP", &XcafDocument::exportSTEP)
+        .function("exportIGES", &XcafDocument::exportIGES);
+
+    class_<XcafDocumentResult>("XcafDocumentResult")
+        .property("document", &XcafDocumentResult::document)
+        .property("timings", &XcafDocumentResult::timings)
+        .property("status", &XcafDocumentResult::status)
+        .property("message", &XcafDocumentResult::message);
+
+    class_<ExportResult>("ExportResult")
+        .property("data", &ExportResult::data)
+        .property("status", &ExportResult::status)
+        .property("message", &ExportResult::message);
+
     class_<Exchange>("Exchange")
         .class_function("importSTEP", &importSTEP)
+        .class_function("importSTEPFromBuffer", &importSTEPFromBuffer)
+        .class_function("importSTEPWithOptions", &importSTEPWithOptions)
+        .class_function("scanSTEP", &scanSTEP)
+        .class_function("importSTEPProducts", &importSTEPProducts)
+        .class_function("importSTEPInstanced", &importSTEPInstanced)
+        .class_function("importSTEPFlat", &importSTEPFlat)
         .class_function("importIGES", &importIGES)
+        .class_function("importIGESFromBuffer", &importIGESFromBuffer)
+        .class_function("importIGESWithOptions", &importIGESWithOptions)
+        .class_function("importIGESInstanced", &importIGESInstanced)
+        .class_function("importIGESFlat", &importIGESFlat)
         .class_function("importSTL", &importSTL)
+        .class_function("importSTLMesh", &importSTLMesh)
+        .class_function("importSTLMeshFromBuffer", &importSTLMeshFromBuffer)
         .class_function("exportSTEP", &exportSTEP)
+        .class_function("exportSTEPWithOptions", &exportSTEPWithOptions)
+        .class_function("exportSTEPInstanced", &exportSTEPInstanced)
         .class_function("exportIGES", &exportIGES)
+        .class_function("exportIGESWithOptions", &exportIGESWithOptions)
+        .class_function("exportIGESInstanced", &exportIGESInstanced)
         .class_function("exportSTL", &exportSTL)
         .class_function("exportBREP", &exportBREP)
-        .class_function("importBREP", &importBREP);
+        .class_function("exportBREPBinary", &exportBREPBinary)
+        .class_function("importBREP", &importBREP)
+        .class_function("importBREPFromBuffer", &importBREPFromBuffer);
 }
 
 } // namespace ExchangeBindings
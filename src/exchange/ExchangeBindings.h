@@ -1,6 +1,184 @@
 #ifndef EXCHANGE_BINDINGS_H
 #define EXCHANGE_BINDINGS_H
 
+#include <TDF_Label.hxx>
+#include <TDocStd_Document.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <emscripten/val.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+EMSCRIPTEN_DECLARE_VAL_TYPE(ShapeNodeArray)
+
+struct ShapeNode {
+    std::optional<TopoDS_Shape> shape;
+    std::optional<std::string> color;
+    std::vector<ShapeNode> children;
+    std::string name;
+
+    ShapeNodeArray getChildren() const {
+        return ShapeNodeArray(emscripten::val::array(children));
+    }
+};
+
+/** 导入各阶段耗时，单位毫秒 */
+struct ImportTimings {
+    double parse;
+    double transfer;
+    double tree;
+};
+
+/**
+ * 带选项的导入结果，status 为 false 时 message 说明失败阶段，被取消时 message 为 "cancelled"
+ */
+struct ImportResult {
+    std::optional<ShapeNode> node;
+    ImportTimings timings {};
+    bool status;
+    std::string message;
+
+    ImportResult() = default;
+    ImportResult(std::optional<ShapeNode> n, bool st, const std::string& m)
+        : node(std::move(n)), status(st), message(m) {}
+
+    static ImportResult failure(const std::string& m) { return ImportResult(std::nullopt, false, m); }
+};
+
+/**
+ * 保留实例化的导入结果，assembly 为
+ * { prototypes: { shape, name, color? }[],
+ *   instances: { prototype: Uint32Array, matrix: Float64Array, names: string[], colors: (string | undefined)[] } }
+ * 每个实例对应 prototype 中的原型序号和 16 个按列主序排列的矩阵元素（可直接用于 InstancedMesh.setMatrixAt）
+ */
+struct InstancedImportResult {
+    emscripten::val assembly = emscripten::val::null();
+    ImportTimings timings {};
+    bool status;
+    std::string message;
+
+    InstancedImportResult() = default;
+    InstancedImportResult(emscripten::val a, bool st, const std::string& m)
+        : assembly(std::move(a)), status(st), message(m) {}
+
+    static InstancedImportResult failure(const std::string& m) { return InstancedImportResult(emscripten::val::null(), false, m); }
+};
+
+/**
+ * 按深度优先前序排列的扁平装配树，每个节点一行，节点 0 为根。
+ * parentIndex: 父节点序号，根为 -1
+ * color: 打包的 RGBA（sRGB），按 R | G << 8 | B << 16 | A << 24 存放，以 Uint8Array 读取时为 [R, G, B, A]，0 表示无颜色
+ * matrix: 每个节点 16 个按列主序排列的元素，为相对父节点的局部位置
+ * nameOffset: 节点数 + 1 个偏移，第 i 个名称为 nameData[nameOffset[i], nameOffset[i + 1]) 的 UTF-8
+ * shapeIndex: 节点在 shapes 中的序号，无几何的节点为 -1，重复出现的零件共用同一 shape
+ */
+struct FlatAssembly {
+    std::vector<int32_t> parentIndex;
+    std::vector<uint32_t> color;
+    std::vector<double> matrix;
+    std::vector<uint32_t> nameOffset;
+    std::vector<uint8_t> nameData;
+    std::vector<int32_t> shapeIndex;
+    std::vector<TopoDS_Shape> shapes;
+};
+
+struct FlatImportResult {
+    FlatAssembly assembly;
+    ImportTimings timings {};
+    bool status;
+    std::string message;
+
+    FlatImportResult() = default;
+    FlatImportResult(FlatAssembly a, bool st, const std::string& m)
+        : assembly(std::move(a)), status(st), message(m) {}
+
+    static FlatImportResult failure(const std::string& m) { return FlatImportResult(FlatAssembly(), false, m); }
+};
+
+/**
+ * 带选项的导出结果，data 为 Uint8Array，失败或取消时为 null
+ */
+struct ExportResult {
+    emscripten::val data = emscripten::val::null();
+    bool status;
+    std::string message;
+
+    ExportResult() = default;
+    ExportResult(emscripten::val d, bool st, const std::string& m)
+        : data(std::move(d)), status(st), message(m) {}
+};
+
+/**
+ * 二进制 BREP 导出参数，JS 侧传入 { withTriangulation?: boolean, withNormals?: boolean }
+ * withTriangulation: 保存 Poly_Triangulation 及边上的 PolygonOnTriangulation（含生成时的 deflection），
+ *                    导入后 MeshCache 按 deflection 判断可直接复用，不再重新划分
+ * withNormals: 同时保存顶点法线，缺少法线的三角化会先按曲面计算
+ */
+struct BRepWriteOptions {
+    bool withTriangulation = true;
+    bool withNormals = false;
+
+    static BRepWriteOptions fromVal(const emscripten::val& options);
+    // 按选项以 BinTools 格式写出 shape
+    void write(const TopoDS_Shape& shape, std::ostream& stream) const;
+};
+
+/**
+ * 跨调用保留的 XCAF 文档：由 ShapeNode 树或导入建立，之后可逐项修改名称、颜色和零件 shape，按需导出。
+ * 节点以 label entry（如 "0:1:1:3"）标识，见 getTree；组件 label 上的名称和颜色只影响该实例，
+ * 零件 label 上的修改影响所有实例，replaceShape 总是替换零件，传入 shape 的位置会被去掉，
+ * 各实例仍使用原组件上的位置（toNode / import 得到的叶子 shape 带有累积位置，可直接传入）。
+ * 修改只更新对应 label，导出时不再重建文档，仅在 shape 变化后执行一次 UpdateAssemblies；
+ * 自上次导出后未修改时直接返回缓存的文件数据。
+ * 复制得到的对象（包括每次读取 XcafDocumentResult.document）共用同一份文档、修改计数和缓存
+ */
+class XcafDocument {
+public:
+  explicit XcafDocument(const Handle(TDocStd_Document)& document);
+
+  static XcafDocument fromNode(const ShapeNode& root);
+
+  // { entry, part, name, color?, isAssembly, children }，part 为组件引用的零件 entry
+  emscripten::val getTree() const;
+  ShapeNode toNode() const;
+
+  bool setName(const std::string& entry, const std::string& name);
+  // color 为 "#RRGGBB"，null / undefined 时移除颜色
+  bool setColor(const std::string& entry, const emscripten::val& color);
+  bool replaceShape(const std::string& entry, const TopoDS_Shape& shape);
+
+  // options 同 Exchange.exportSTEPWithOptions / exportIGESWithOptions
+  ExportResult exportSTEP(const emscripten::val& options);
+  ExportResult exportIGES(const emscripten::val& options);
+
+private:
+  struct State;
+
+  TDF_Label findLabel(const std::string& entry) const;
+  void prepareExport();
+
+  std::shared_ptr<State> state;
+};
+
+struct XcafDocumentResult {
+    std::optional<XcafDocument> document;
+    ImportTimings timings {};
+    bool status;
+    std::string message;
+
+    XcafDocumentResult() = default;
+    XcafDocumentResult(std::optional<XcafDocument> d, bool st, const std::string& m)
+        : document(std::move(d)), status(st), message(m) {}
+
+    static XcafDocumentResult failure(const std::string& m) { return XcafDocumentResult(std::nullopt, false, m); }
+};
+
 namespace ExchangeBindings {
     void registerBindings();
 }
@@ -0,0 +1,513 @@
+#include "ProjectBindings.h"
+#include "ExchangeBindings.h"
+#include "shared/Shared.hpp"
+
+#include <BinTools.hxx>
+#include <TopAbs_Orientation.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS_Shape.hxx>
+#include <TopoDS_TShape.hxx>
+#include <gp.hxx>
+#include <gp_Trsf.hxx>
+
+#include <emscripten/bind.h>
+#include <emscripten/val.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace emscripten;
+
+/*
+ * 项目文件格式（小端）
+ * 文件头: magic "OCCTPROJ" | version u32 | sectionCount u32
+ * 段索引: sectionCount × { id char[4] | reserved u32 | offset u64 | size u64 }，offset 相对文件起始
+ * SHPS 共享 shape 表: count u32 | count × { offset u64 | size u64 }（相对段起始）| BinTools 数据
+ *      每个 TShape 只保存一次，位置和朝向记录在引用它的节点上
+ * NODS 节点表: count u32 | count × NodeRecord，按 ShapeNode 深度优先先序排列
+ *      节点 i 的子树为 [i, subtreeEnd)，加载子树时只读取其引用的 shape
+ * STRS 字符串表: 名称与颜色的 UTF-8 数据
+ */
+
+namespace {
+
+constexpr char PROJECT_MAGIC[8] = { 'O', 'C', 'C', 'T', 'P', 'R', 'O', 'J' };
+constexpr uint32_t PROJECT_VERSION = 1;
+constexpr uint32_t NO_VALUE = 0xFFFFFFFFu;
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t SECTION_ENTRY_SIZE = 24;
+
+struct NodeRecord {
+    int32_t parent;
+    uint32_t subtreeEnd;
+    int32_t shape;
+    uint32_t orientation;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t colorOffset;
+    uint32_t colorLength;
+    // 位置变换的 3x4 矩阵，行主序
+    double matrix[12];
+};
+static_assert(sizeof(NodeRecord) == 128, "NodeRecord layout is part of the file format");
+
+template<typename T>
+void appendValue(std::vector<uint8_t>& output, const T& value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    output.insert(output.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+T readValue(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// ==================== Save ====================
+
+struct ProjectData {
+    std::vector<NodeRecord> nodes;
+    std::string strings;
+    std::vector<std::string> shapes;
+    std::map<const TopoDS_TShape*, int32_t> shapeIndices;
+};
+
+uint32_t addString(ProjectData& data, const std::string& value) {
+    const uint32_t offset = static_cast<uint32_t>(data.strings.size());
+    data.strings += value;
+    return offset;
+}
+
+int32_t addShape(ProjectData& data, const TopoDS_Shape& shape, const BRepWriteOptions& options) {
+    const TopoDS_TShape* tshape = shape.TShape().get();
+    auto it = data.shapeIndices.find(tshape);
+    if (it != data.shapeIndices.end()) {
+        return it->second;
+    }
+
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+    options.write(shape.Located(TopLoc_Location()).Oriented(TopAbs_FORWARD), oss);
+    const int32_t index = static_cast<int32_t>(data.shapes.size());
+    data.shapes.push_back(oss.str());
+    data.shapeIndices.emplace(tshape, index);
+    return index;
+}
+
+void addNode(ProjectData& data, const ShapeNode& node, int32_t parent, const BRepWriteOptions& options) {
+    NodeRecord record {};
+    record.parent = parent;
+    record.shape = -1;
+    record.nameOffset = addString(data, node.name);
+    record.nameLength = static_cast<uint32_t>(node.name.size());
+    record.colorOffset = NO_VALUE;
+    record.colorLength = 0;
+    if (node.color.has_value()) {
+        record.colorOffset = addString(data, node.color.value());
+        record.colorLength = static_cast<uint32_t>(node.color->size());
+    }
+
+    gp_Trsf trsf;
+    if (node.shape.has_value() && !node.shape->IsNull()) {
+        record.shape = addShape(data, node.shape.value(), options);
+        record.orientation = static_cast<uint32_t>(node.shape->Orientation());
+        trsf = node.shape->Location().Transformation();
+    }
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 4; col++) {
+            record.matrix[row * 4 + col] = trsf.Value(row + 1, col + 1);
+        }
+    }
+
+    const size_t index = data.nodes.size();
+    data.nodes.push_back(record);
+    for (const ShapeNode& child : node.children) {
+        addNode(data, child, static_cast<int32_t>(index), options);
+    }
+    data.nodes[index].subtreeEnd = static_cast<uint32_t>(data.nodes.size());
+}
+
+void appendSection(std::vector<uint8_t>& output, size_t entryIndex, const char id[4], const std::vector<uint8_t>& section) {
+    uint8_t* entry = output.data() + HEADER_SIZE + entryIndex * SECTION_ENTRY_SIZE;
+    const uint64_t offset = output.size();
+    const uint64_t size = section.size();
+    std::memcpy(entry, id, 4);
+    std::memcpy(entry + 8, &offset, sizeof(offset));
+    std::memcpy(entry + 16, &size, sizeof(size));
+    output.insert(output.end(), section.begin(), section.end());
+}
+
+std::vector<uint8_t> writeProject(const ProjectData& data) {
+    std::vector<uint8_t> shapes;
+    appendValue(shapes, static_cast<uint32_t>(data.shapes.size()));
+    uint64_t shapeOffset = 4 + data.shapes.size() * 16;
+    for (const std::string& blob : data.shapes) {
+        appendValue(shapes, shapeOffset);
+        appendValue(shapes, static_cast<uint64_t>(blob.size()));
+        shapeOffset += blob.size();
+    }
+    for (const std::string& blob : data.shapes) {
+        shapes.insert(shapes.end(), blob.begin(), blob.end());
+    }
+
+    std::vector<uint8_t> nodes;
+    appendValue(nodes, static_cast<uint32_t>(data.nodes.size()));
+    const uint8_t* records = reinterpret_cast<const uint8_t*>(data.nodes.data());
+    nodes.insert(nodes.end(), records, records + data.nodes.size() * sizeof(NodeRecord));
+
+    const std::vector<uint8_t> strings(data.strings.begin(), data.strings.end());
+
+    std::vector<uint8_t> output;
+    output.reserve(HEADER_SIZE + 3 * SECTION_ENTRY_SIZE + shapes.size() + nodes.size() + strings.size());
+    output.insert(output.end(), PROJECT_MAGIC, PROJECT_MAGIC + sizeof(PROJECT_MAGIC));
+    appendValue(output, PROJECT_VERSION);
+    appendValue(output, static_cast<uint32_t>(3));
+    output.resize(HEADER_SIZE + 3 * SECTION_ENTRY_SIZE, 0);
+
+    // 节点表与字符串表在前，只读取索引时无需跨过 shape 数据
+    appendSection(output, 0, "NODS", nodes);
+    appendSection(output, 1, "STRS", strings);
+    appendSection(output, 2, "SHPS", shapes);
+    return output;
+}
+
+// ==================== Load ====================
+
+/** 按偏移读取项目数据，Uint8Array 与 HeapBuffer 各有实现，只拷贝用到的区间 */
+class ProjectSource {
+public:
+    virtual ~ProjectSource() = default;
+    virtual size_t size() const = 0;
+    virtual bool read(size_t offset, size_t size, uint8_t* output) const = 0;
+
+    // 文件中的偏移和长度为 u64，按 u64 比较，wasm32 上 size_t 只有 32 位，不能先转换再判断
+    bool contains(uint64_t offset, uint64_t size) const {
+        const uint64_t total = this->size();
+        return offset <= total && size <= total - offset;
+    }
+
+    // 区间超出数据范围时返回空数组，不会按损坏的长度分配内存
+    std::vector<uint8_t> read(uint64_t offset, uint64_t size) const {
+        std::vector<uint8_t> result;
+        if (!contains(offset, size)) {
+            return result;
+        }
+        result.resize(static_cast<size_t>(size));
+        if (!read(static_cast<size_t>(offset), static_cast<size_t>(size), result.data())) {
+            result.clear();
+        }
+        return result;
+    }
+};
+
+class Uint8ArraySource : public ProjectSource {
+public:
+    explicit Uint8ArraySource(const Uint8Array& array_)
+        : array(array_), length(array_["length"].as<size_t>()) {}
+
+    size_t size() const override { return length; }
+
+    bool read(size_t offset, size_t size, uint8_t* output) const override {
+        if (offset > length || size > length - offset) {
+            return false;
+        }
+        toMemoryView(output, size).call<void>("set", array.call<val>("subarray", offset, offset + size));
+        return true;
+    }
+
+private:
+    val array;
+    size_t length;
+};
+
+class HeapBufferSource : public ProjectSource {
+public:
+    explicit HeapBufferSource(const HeapBuffer& buffer_) : buffer(buffer_) {}
+
+    size_t size() const override { return buffer.size(); }
+
+    bool read(size_t offset, size_t size, uint8_t* output) const override {
+        if (offset > buffer.size() || size > buffer.size() - offset) {
+            return false;
+        }
+        size_t start = 0;
+        for (const auto& chunk : buffer.getChunks()) {
+            const size_t end = start + chunk.size();
+            if (size > 0 && offset < end) {
+                const size_t count = std::min(end - offset, size);
+                std::memcpy(output, chunk.data() + (offset - start), count);
+                output += count;
+                offset += count;
+                size -= count;
+            }
+            start = end;
+        }
+        return size == 0;
+    }
+
+private:
+    const HeapBuffer& buffer;
+};
+
+struct ProjectIndex {
+    std::vector<NodeRecord> nodes;
+    std::string strings;
+    uint64_t shapesOffset = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> shapeEntries;
+};
+
+bool readProjectIndex(const ProjectSource& source, ProjectIndex& index) {
+    std::vector<uint8_t> header = source.read(0, HEADER_SIZE);
+    if (header.empty() || std::memcmp(header.data(), PROJECT_MAGIC, sizeof(PROJECT_MAGIC)) != 0
+        || readValue<uint32_t>(header.data() + 8) != PROJECT_VERSION) {
+        return false;
+    }
+
+    const uint32_t sectionCount = readValue<uint32_t>(header.data() + 12);
+    const uint64_t entriesSize = static_cast<uint64_t>(sectionCount) * SECTION_ENTRY_SIZE;
+    std::vector<uint8_t> entries = source.read(HEADER_SIZE, entriesSize);
+    if (entries.size() != entriesSize) {
+        return false;
+    }
+
+    bool hasNodes = false;
+    bool hasShapes = false;
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        const uint8_t* entry = entries.data() + static_cast<size_t>(i) * SECTION_ENTRY_SIZE;
+        const std::string id(reinterpret_cast<const char*>(entry), 4);
+        const uint64_t offset = readValue<uint64_t>(entry + 8);
+        const uint64_t size = readValue<uint64_t>(entry + 16);
+        if (!source.contains(offset, size)) {
+            return false;
+        }
+
+        if (id == "NODS") {
+            std::vector<uint8_t> nodes = source.read(offset, size);
+            if (nodes.size() < 4) {
+                return false;
+            }
+            const uint32_t count = readValue<uint32_t>(nodes.data());
+            if (static_cast<uint64_t>(count) * sizeof(NodeRecord) > nodes.size() - 4) {
+                return false;
+            }
+            index.nodes.resize(count);
+            std::memcpy(index.nodes.data(), nodes.data() + 4, static_cast<size_t>(count) * sizeof(NodeRecord));
+            hasNodes = true;
+        } else if (id == "STRS") {
+            std::vector<uint8_t> strings = source.read(offset, size);
+            index.strings.assign(strings.begin(), strings.end());
+        } else if (id == "SHPS") {
+            std::vector<uint8_t> countData = source.read(offset, 4);
+            if (countData.empty()) {
+                return false;
+            }
+            const uint32_t count = readValue<uint32_t>(countData.data());
+            const uint64_t tableSize = static_cast<uint64_t>(count) * 16;
+            if (size < 4 || tableSize > size - 4) {
+                return false;
+            }
+            std::vector<uint8_t> table = source.read(offset + 4, tableSize);
+            if (table.size() != tableSize) {
+                return false;
+            }
+            index.shapesOffset = offset;
+            index.shapeEntries.reserve(count);
+            for (uint32_t j = 0; j < count; j++) {
+                const uint8_t* shapeEntry = table.data() + static_cast<size_t>(j) * 16;
+                index.shapeEntries.emplace_back(readValue<uint64_t>(shapeEntry), readValue<uint64_t>(shapeEntry + 8));
+            }
+            hasShapes = true;
+        }
+    }
+    return hasNodes && hasShapes;
+}
+
+std::string readString(const ProjectIndex& index, uint32_t offset, uint32_t length) {
+    if (offset == NO_VALUE || offset > index.strings.size()) {
+        return std::string();
+    }
+    return index.strings.substr(offset, length);
+}
+
+TopoDS_Shape readShape(const ProjectSource& source, const ProjectIndex& index, int32_t shapeIndex,
+    std::map<int32_t, TopoDS_Shape>& loaded) {
+    auto it = loaded.find(shapeIndex);
+    if (it != loaded.end()) {
+        return it->second;
+    }
+
+    TopoDS_Shape shape;
+    if (shapeIndex >= 0 && static_cast<size_t>(shapeIndex) < index.shapeEntries.size()) {
+        const auto& entry = index.shapeEntries[shapeIndex];
+        // shapesOffset 已确认位于数据内，先比较再相加避免 u64 溢出
+        std::vector<uint8_t> blob;
+        if (entry.first <= source.size() - index.shapesOffset) {
+            blob = source.read(index.shapesOffset + entry.first, entry.second);
+        }
+        if (!blob.empty()) {
+            std::istringstream iss(std::string(blob.begin(), blob.end()), std::ios::in | std::ios::binary);
+            BinTools::Read(shape, iss);
+        }
+    }
+    loaded.emplace(shapeIndex, shape);
+    return shape;
+}
+
+/** 矩阵元素均为有限值且线性部分可逆时才能交给 gp_Trsf::SetValues，否则其会抛出异常 */
+bool isValidMatrix(const double* m) {
+    for (int i = 0; i < 12; i++) {
+        if (!std::isfinite(m[i])) {
+            return false;
+        }
+    }
+    const double det = m[0] * (m[5] * m[10] - m[6] * m[9])
+        - m[1] * (m[4] * m[10] - m[6] * m[8])
+        + m[2] * (m[4] * m[9] - m[5] * m[8]);
+    return std::abs(det) > gp::Resolution();
+}
+
+/**
+ * 是否为保存时的单位矩阵。gp_Trsf::SetValues 总把 Form 设为 gp_CompoundTrsf，不能用 Form 判断，
+ * 单位位置写出的元素恰为 0 / 1，这里按值精确比较
+ */
+bool isIdentityMatrix(const double* m) {
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 4; col++) {
+            if (m[row * 4 + col] != (row == col ? 1.0 : 0.0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/** 节点矩阵或朝向损坏时返回 std::nullopt，整个加载失败 */
+std::optional<ShapeNode> buildNode(const ProjectSource& source, const ProjectIndex& index, uint32_t nodeIndex,
+    std::map<int32_t, TopoDS_Shape>& loaded) {
+    const NodeRecord& record = index.nodes[nodeIndex];
+    ShapeNode node {
+        .shape = std::nullopt,
+        .color = std::nullopt,
+        .children = {},
+        .name = readString(index, record.nameOffset, record.nameLength),
+    };
+    if (record.colorOffset != NO_VALUE) {
+        node.color = readString(index, record.colorOffset, record.colorLength);
+    }
+
+    if (record.shape >= 0) {
+        TopoDS_Shape shape = readShape(source, index, record.shape, loaded);
+        if (!shape.IsNull()) {
+            const double* m = record.matrix;
+            // 朝向超出 TopAbs_EXTERNAL 时，TopAbs::Compose / Reverse 的查表会越界
+            if (!isValidMatrix(m) || record.orientation > static_cast<uint32_t>(TopAbs_EXTERNAL)) {
+                return std::nullopt;
+            }
+            // 单位位置不设 Location，共用 TShape 的节点与未定位的原 shape 保持 IsSame
+            if (!isIdentityMatrix(m)) {
+                gp_Trsf trsf;
+                trsf.SetValues(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11]);
+                shape.Location(TopLoc_Location(trsf));
+            }
+            shape.Orientation(static_cast<TopAbs_Orientation>(record.orientation));
+            node.shape = shape;
+        }
+    }
+
+    const uint32_t end = std::min<uint32_t>(record.subtreeEnd, static_cast<uint32_t>(index.nodes.size()));
+    for (uint32_t child = nodeIndex + 1; child < end; child = std::max(index.nodes[child].subtreeEnd, child + 1)) {
+        std::optional<ShapeNode> childNode = buildNode(source, index, child, loaded);
+        if (!childNode.has_value()) {
+            return std::nullopt;
+        }
+        node.children.push_back(std::move(childNode.value()));
+    }
+    return node;
+}
+
+std::optional<ShapeNode> loadSubtree(const ProjectSource& source, uint32_t nodeIndex) {
+    ProjectIndex index;
+    if (!readProjectIndex(source, index) || nodeIndex >= index.nodes.size()) {
+        return std::nullopt;
+    }
+    std::map<int32_t, TopoDS_Shape> loaded;
+    return buildNode(source, index, nodeIndex, loaded);
+}
+
+// ==================== API ====================
+
+/**
+ * @description: 将 ShapeNode 树保存为二进制项目文件，共享同一 TShape 的节点只保存一份几何
+ * @param {ShapeNode&} root
+ * @param {BRepWriteOptions} options 同 exportBREPBinary
+ * @return {Uint8Array}
+ */
+val save(const ShapeNode& root, const val& options) {
+    ProjectData data;
+    addNode(data, root, -1, BRepWriteOptions::fromVal(options));
+    return copyToTypedArray(writeProject(data));
+}
+
+/**
+ * @description: 同 save，但结果留在 wasm 堆上，不再整份拷贝到 JS；
+ * 可直接交给 loadFromBuffer，或用 getViews() 写出后 delete()
+ * @param {ShapeNode&} root
+ * @param {BRepWriteOptions} options 同 exportBREPBinary
+ * @return {HeapBuffer}
+ */
+HeapBuffer saveToBuffer(const ShapeNode& root, const val& options) {
+    ProjectData data;
+    addNode(data, root, -1, BRepWriteOptions::fromVal(options));
+    HeapBuffer buffer;
+    buffer.adopt(writeProject(data));
+    return buffer;
+}
+
+std::optional<ShapeNode> load(const Uint8Array& buffer) {
+    return loadSubtree(Uint8ArraySource(buffer), 0);
+}
+
+std::optional<ShapeNode> loadFromBuffer(const HeapBuffer& buffer) {
+    return loadSubtree(HeapBufferSource(buffer), 0);
+}
+
+/**
+ * @description: 只加载一棵子树，nodeIndex 为节点在 ShapeNode 树深度优先先序中的序号（根为 0）
+ * @param {Uint8Array&} buffer
+ * @param {number} nodeIndex
+ * @return {ShapeNode | undefined}
+ */
+std::optional<ShapeNode> loadSubtreeFromArray(const Uint8Array& buffer, uint32_t nodeIndex) {
+    return loadSubtree(Uint8ArraySource(buffer), nodeIndex);
+}
+
+std::optional<ShapeNode> loadSubtreeFromBuffer(const HeapBuffer& buffer, uint32_t nodeIndex) {
+    return loadSubtree(HeapBufferSource(buffer), nodeIndex);
+}
+
+} // anonymous namespace
+
+namespace ProjectBindings {
+
+struct Project {};
+
+void registerBindings() {
+    class_<Project>("Project")
+        .class_function("save", &save)
+        .class_function("saveToBuffer", &saveToBuffer)
+        .class_function("load", &load)
+        .class_function("loadFromBuffer", &loadFromBuffer)
+        .class_function("loadSubtree", &loadSubtreeFromArray)
+        .class_function("loadSubtreeFromBuffer", &loadSubtreeFromBuffer);
+}
+
+} // namespace ProjectBindings
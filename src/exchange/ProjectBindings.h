@@ -0,0 +1,8 @@
+#ifndef PROJECT_BINDINGS_H
+#define PROJECT_BINDINGS_H
+
+namespace ProjectBindings {
+    void registerBindings();
+}
+
+#endif
@@ -23,12 +23,111 @@
 #include <BRepOffsetAPI_ThruSections.hxx>
 #include <ShapeUpgrade_UnifySameDomain.hxx>
 #include <GeomAbs_Shape.hxx>
+#include <BRepTools_History.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <utility>
+#include <vector>
 
 
 using namespace emscripten;
 
 namespace {
 
+/**
+ * 带建模历史的结果，面均为输入 shape 中的面（generated 与 modified 的 images 为结果中的面）
+ * kept: 未变化、原样保留在结果中的输入面，其三角化可直接复用
+ * modified: 被修改的输入面及其在结果中的替代面
+ * deleted: 结果中不再存在的输入面
+ * generated: 由输入的顶点/边/面生成的新面，如圆角面、倒角面
+ */
+struct HistoryResult : public TopoResult {
+    std::vector<TopoDS_Face> kept;
+    std::vector<std::pair<TopoDS_Face, std::vector<TopoDS_Face>>> modified;
+    std::vector<TopoDS_Face> deleted;
+    std::vector<TopoDS_Face> generated;
+
+    HistoryResult() = default;
+    HistoryResult(const TopoDS_Shape& s, bool st, const std::string& m)
+        : TopoResult(s, st, m) {}
+};
+
+/**
+ * @description: 根据 BRepTools_History 归类所有输入面的去向
+ * @param {TopoDS_Shape&} shape 运算结果
+ * @param {TopTools_ListOfShape&} inputs 参与运算的输入 shape
+ * @param {Handle(BRepTools_History)&} history 运算历史
+ * @return {HistoryResult}
+ */
+HistoryResult collectFaceHistory(const TopoDS_Shape& shape, const TopTools_ListOfShape& inputs, const Handle(BRepTools_History)& history) {
+    HistoryResult result(shape, true, "");
+    if (history.IsNull()) {
+        return result;
+    }
+
+    TopTools_IndexedMapOfShape inputFaces;
+    TopTools_IndexedMapOfShape inputSubShapes;
+    for (const TopoDS_Shape& input : inputs) {
+        TopExp::MapShapes(input, TopAbs_FACE, inputFaces);
+        TopExp::MapShapes(input, inputSubShapes);
+    }
+
+    for (Standard_Integer i = 1; i <= inputFaces.Extent(); i++) {
+        const TopoDS_Face& face = TopoDS::Face(inputFaces(i));
+        if (history->IsRemoved(face)) {
+            result.deleted.push_back(face);
+            continue;
+        }
+        const TopTools_ListOfShape& images = history->Modified(face);
+        if (images.IsEmpty()) {
+            result.kept.push_back(face);
+            continue;
+        }
+        std::vector<TopoDS_Face> imageFaces;
+        for (const TopoDS_Shape& image : images) {
+            if (image.ShapeType() == TopAbs_FACE) {
+                imageFaces.push_back(TopoDS::Face(image));
+            }
+        }
+        result.modified.emplace_back(face, std::move(imageFaces));
+    }
+
+    TopTools_IndexedMapOfShape generatedFaces;
+    for (Standard_Integer i = 1; i <= inputSubShapes.Extent(); i++) {
+        if (!BRepTools_History::IsSupportedType(inputSubShapes(i))) {
+            continue;
+        }
+        for (const TopoDS_Shape& generated : history->Generated(inputSubShapes(i))) {
+            if (generated.ShapeType() == TopAbs_FACE && generatedFaces.Add(generated)) {
+                result.generated.push_back(TopoDS::Face(generated));
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @description: 转为 JS 对象
+ * @return {{ kept: Face[], modified: { face: Face, images: Face[] }[], deleted: Face[], generated: Face[] }}
+ */
+val historyToObject(const HistoryResult& result) {
+    val modified = val::array();
+    for (const auto& entry : result.modified) {
+        val item = val::object();
+        item.set("face", entry.first);
+        item.set("images", topoVectorToArray(entry.second));
+        modified.call<void>("push", item);
+    }
+
+    val obj = val::object();
+    obj.set("kept", topoVectorToArray(result.kept));
+    obj.set("modified", modified);
+    obj.set("deleted", topoVectorToArray(result.deleted));
+    obj.set("generated", topoVectorToArray(result.generated));
+    return obj;
+}
+
 /**
  * @description: 倒圆角
  * @param {TopoDS_Shape&} shape
@@ -52,6 +151,30 @@ TopoResult fillet(const TopoDS_Shape& shape, const TopoEdgeArray& edges, double
     }
 }
 
+/**
+ * @description: 倒圆角，同时返回输入面的建模历史
+ * @param {TopoDS_Shape&} shape
+ * @param {TopoEdgeArray&} edges
+ * @param {double} radius
+ * @return {HistoryResult} 倒圆角后的shape及历史
+ */
+HistoryResult filletWithHistory(const TopoDS_Shape& shape, const TopoEdgeArray& edges, double radius) {
+    std::vector<TopoDS_Edge> edgeList = emscripten::vecFromJSArray<TopoDS_Edge>(edges);
+    BRepFilletAPI_MakeFillet filletBuilder(shape);
+    for (const TopoDS_Edge& edge : edgeList) {
+        if (!edge.IsNull()) {
+            filletBuilder.Add(radius, edge);
+        }
+    }
+    filletBuilder.Build();
+    if (!filletBuilder.IsDone()) {
+        return HistoryResult(TopoDS_Shape(), false, "Fillet operation failed");
+    }
+    TopTools_ListOfShape inputs;
+    inputs.Append(shape);
+    return collectFaceHistory(filletBuilder.Shape(), inputs, new BRepTools_History(inputs, filletBuilder));
+}
+
 /**
  * @description: 倒角
  * @param {TopoDS_Shape&} shape
@@ -75,6 +198,30 @@ TopoResult chamfer(const TopoDS_Shape& shape, const TopoEdgeArray& edges, double
     }
 }
 
+/**
+ * @description: 倒角，同时返回输入面的建模历史
+ * @param {TopoDS_Shape&} shape
+ * @param {TopoEdgeArray&} edges
+ * @param {double} distance
+ * @return {HistoryResult} 倒角后的shape及历史
+ */
+HistoryResult chamferWithHistory(const TopoDS_Shape& shape, const TopoEdgeArray& edges, double distance) {
+    std::vector<TopoDS_Edge> edgeList = emscripten::vecFromJSArray<TopoDS_Edge>(edges);
+    BRepFilletAPI_MakeChamfer chamferBuilder(shape);
+    for (const TopoDS_Edge& edge : edgeList) {
+        if (!edge.IsNull()) {
+            chamferBuilder.Add(distance, edge);
+        }
+    }
+    chamferBuilder.Build();
+    if (!chamferBuilder.IsDone()) {
+        return HistoryResult(TopoDS_Shape(), false, "Chamfer operation failed");
+    }
+    TopTools_ListOfShape inputs;
+    inputs.Append(shape);
+    return collectFaceHistory(chamferBuilder.Shape(), inputs, new BRepTools_History(inputs, chamferBuilder));
+}
+
 /**
  * @description: 拉伸
  * @param {TopoDS_Shape&} shape
@@ -98,14 +245,15 @@ TopoResult prism(const TopoDS_Shape& shape, const Vector3& direction) {
  * @param {BRepAlgoAPI_BooleanOperation&} boolOperator
  * @param {TopoShapeArray&} args
  * @param {TopoShapeArray&} tools
+ * @param {bool} fillHistory 是否记录历史，关闭时运算更快
  * @return {TopoResult} 布尔运算后的shape
  */
-TopoResult booleanOperate(BRepAlgoAPI_BooleanOperation& boolOperator, const TopoShapeArray& args, const TopoShapeArray& tools, double fuzzyValue){
+TopoResult booleanOperate(BRepAlgoAPI_BooleanOperation& boolOperator, const TopoShapeArray& args, const TopoShapeArray& tools, double fuzzyValue, bool fillHistory = false){
     TopTools_ListOfShape argsList = topoShapeArrayToListOfShape(args);
     TopTools_ListOfShape toolsList = topoShapeArrayToListOfShape(tools);
 
     boolOperator.SetFuzzyValue(fuzzyValue);
-    boolOperator.SetToFillHistory(false);
+    boolOperator.SetToFillHistory(fillHistory);
     boolOperator.SetArguments(argsList);
     boolOperator.SetTools(toolsList);
     boolOperator.Build();
@@ -116,6 +264,23 @@ TopoResult booleanOperate(BRepAlgoAPI_BooleanOperation& boolOperator, const Topo
     }
 }
 
+/**
+ * @description: 布尔运算，同时返回 args 与 tools 中各面的建模历史
+ * @param {BRepAlgoAPI_BooleanOperation&} boolOperator
+ * @param {TopoShapeArray&} args
+ * @param {TopoShapeArray&} tools
+ * @return {HistoryResult} 布尔运算后的shape及历史
+ */
+HistoryResult booleanOperateWithHistory(BRepAlgoAPI_BooleanOperation& boolOperator, const TopoShapeArray& args, const TopoShapeArray& tools, double fuzzyValue) {
+    TopoResult result = booleanOperate(boolOperator, args, tools, fuzzyValue, true);
+    if (!result.status) {
+        return HistoryResult(TopoDS_Shape(), false, result.message);
+    }
+    TopTools_ListOfShape inputs = topoShapeArrayToListOfShape(args);
+    inputs.Append(topoShapeArrayToListOfShape(tools));
+    return collectFaceHistory(result.shape, inputs, boolOperator.History());
+}
+
 /**
  * @description: 并集
  * @param {TopoShapeArray&} args
@@ -149,6 +314,21 @@ TopoResult intersection(const TopoShapeArray& args, const TopoShapeArray& tools,
     return booleanOperate(boolOperator, args, tools, fuzzyValue);
 }
 
+HistoryResult fuseWithHistory(const TopoShapeArray& args, const TopoShapeArray& tools, double fuzzyValue = Constants::EPSILON) {
+    BRepAlgoAPI_Fuse boolOperator;
+    return booleanOperateWithHistory(boolOperator, args, tools, fuzzyValue);
+}
+
+HistoryResult differenceWithHistory(const TopoShapeArray& args, const TopoShapeArray& tools, double fuzzyValue = Constants::EPSILON) {
+    BRepAlgoAPI_Cut boolOperator;
+    return booleanOperateWithHistory(boolOperator, args, tools, fuzzyValue);
+}
+
+HistoryResult intersectionWithHistory(const TopoShapeArray& args, const TopoShapeArray& tools, double fuzzyValue = Constants::EPSILON) {
+    BRepAlgoAPI_Common boolOperator;
+    return booleanOperateWithHistory(boolOperator, args, tools, fuzzyValue);
+}
+
 /**
  * @description: 旋转
  * @param {TopoDS_Shape&} shape
@@ -294,6 +474,9 @@ namespace ModelerBindings {
 struct Modeler {};
 
 void registerBindings() {
+    class_<HistoryResult, base<TopoResult>>("HistoryResult")
+        .function("getHistory", &historyToObject);
+
     class_<Modeler>("Modeler")
         .class_function("fillet", &fillet)
         .class_function("chamfer", &chamfer)
@@ -301,6 +484,11 @@ void registerBindings() {
         .class_function("union", &fuse)
         .class_function("difference", &difference)
         .class_function("intersection", &intersection)
+        .class_function("filletWithHistory", &filletWithHistory)
+        .class_function("chamferWithHistory", &chamferWithHistory)
+        .class_function("unionWithHistory", &fuseWithHistory)
+        .class_function("differenceWithHistory", &differenceWithHistory)
+        .class_function("intersectionWithHistory", &intersectionWithHistory)
         .class_function("revolve", &revolve)
         .class_function("sweep", &sweep)
         .class_function("thickSolid", &thickSolid)
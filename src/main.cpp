@@ -6,7 +6,9 @@
 #include "geometry/CurveBindings.h"
 #include "geometry/ModelerBindings.h"
 #include "brep/BRepBindings.h"
+#include "mesh/MeshBindings.h"
 #include "exchange/ExchangeBindings.h"
+#include "exchange/ProjectBindings.h"
 
 EMSCRIPTEN_BINDINGS(occt_wasm_module) {
     // Register all module bindings
@@ -16,6 +18,8 @@ EMSCRIPTEN_BINDINGS(occt_wasm_module) {
     CurveBindings::registerBindings();
     GeometryBindings::registerBindings();
     ModelerBindings::registerBindings();
+    MeshBindings::registerBindings();
     ExchangeBindings::registerBindings();
+    ProjectBindings::registerBindings();
 }
 
@@ -0,0 +1,1101 @@
+#include "MeshBindings.h"
+#include "brep/ShapeBindings.h"
+#include "exchange/ExchangeBindings.h"
+#include "shared/Shared.hpp"
+
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepTools.hxx>
+#include <Bnd_Box.hxx>
+#include <Geom_Surface.hxx>
+#include <OSD_ThreadPool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_TShape.hxx>
+#include <TopTools_DataMapOfShapeInteger.hxx>
+#include <TopTools_DataMapOfShapeShape.hxx>
+#include <gp_Pnt2d.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+#include <gp_XYZ.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <emscripten/bind.h>
+#include <emscripten/val.h>
+#ifdef OCCT_WASM_THREADS
+#include <emscripten/threading.h>
+
+// 与链接参数 -sPTHREAD_POOL_SIZE 一致，由 CMake 传入
+#ifndef OCCT_WASM_PTHREAD_POOL_SIZE
+#define OCCT_WASM_PTHREAD_POOL_SIZE 4
+#endif
+#endif
+
+using namespace emscripten;
+
+// ==================== MeshOptions ====================
+
+namespace {
+
+bool& parallelDefault() {
+    static bool parallel = false;
+    return parallel;
+}
+
+NormalMode parseNormalMode(const std::string& mode) {
+    if (mode == "angle") return NormalMode::Angle;
+    if (mode == "area") return NormalMode::Area;
+    return NormalMode::Surface;
+}
+
+} // anonymous namespace
+
+MeshOptions::MeshOptions(double lineDeflection_, double angleDeviation_)
+    : lineDeflection(lineDeflection_), angleDeviation(angleDeviation_), parallel(parallelDefault()),
+      normalMode(NormalMode::Surface), creaseAngle(0.0) {}
+
+MeshOptions MeshOptions::fromVal(const val& options) {
+    MeshOptions result;
+    if (options.isUndefined() || options.isNull()) {
+        return result;
+    }
+    val lineDeflection = options["lineDeflection"];
+    val angleDeviation = options["angleDeviation"];
+    val parallel = options["parallel"];
+    val normalMode = options["normalMode"];
+    val creaseAngle = options["creaseAngle"];
+    if (!lineDeflection.isUndefined()) result.lineDeflection = lineDeflection.as<double>();
+    if (!angleDeviation.isUndefined()) result.angleDeviation = angleDeviation.as<double>();
+    if (!parallel.isUndefined()) result.parallel = parallel.as<bool>();
+    if (!normalMode.isUndefined()) result.normalMode = parseNormalMode(normalMode.as<std::string>());
+    if (!creaseAngle.isUndefined()) result.creaseAngle = creaseAngle.as<double>();
+    return result;
+}
+
+// ==================== MeshNormals ====================
+
+namespace {
+
+gp_XYZ nodeAt(const std::vector<float>& position, uint32_t index) {
+    return gp_XYZ(position[index * 3], position[index * 3 + 1], position[index * 3 + 2]);
+}
+
+// 两条边之间的夹角，对零长度边返回 0
+double cornerAngle(const gp_XYZ& e1, const gp_XYZ& e2) {
+    return std::atan2(e1.Crossed(e2).Modulus(), e1.Dot(e2));
+}
+
+/**
+ * 计算每个三角形的单位法线以及三个角的权重
+ * Area 模式权重为三角形面积（的两倍），其余模式为角的大小
+ */
+void computeTriangleNormals(const FaceResult& result, NormalMode mode,
+    std::vector<gp_XYZ>& triangleNormals, std::vector<double>& cornerWeights) {
+    const size_t nbTriangles = result.index.size() / 3;
+    triangleNormals.assign(nbTriangles, gp_XYZ(0.0, 0.0, 0.0));
+    cornerWeights.assign(nbTriangles * 3, 0.0);
+
+    for (size_t t = 0; t < nbTriangles; t++) {
+        const gp_XYZ a = nodeAt(result.position, result.index[t * 3]);
+        const gp_XYZ b = nodeAt(result.position, result.index[t * 3 + 1]);
+        const gp_XYZ c = nodeAt(result.position, result.index[t * 3 + 2]);
+        gp_XYZ normal = (b - a).Crossed(c - a);
+        const double length = normal.Modulus();
+        if (length <= 0.0) {
+            continue;
+        }
+        triangleNormals[t] = normal / length;
+        if (mode == NormalMode::Area) {
+            cornerWeights[t * 3] = cornerWeights[t * 3 + 1] = cornerWeights[t * 3 + 2] = length;
+        } else {
+            cornerWeights[t * 3] = cornerAngle(b - a, c - a);
+            cornerWeights[t * 3 + 1] = cornerAngle(c - b, a - b);
+            cornerWeights[t * 3 + 2] = cornerAngle(a - c, b - c);
+        }
+    }
+}
+
+// 写入第 index 个顶点的单位法线，零向量时与旧实现一致取 (0, 0, 1)
+void setNormal(std::vector<float>& normals, size_t index, const gp_XYZ& normal) {
+    const double length = normal.Modulus();
+    const gp_XYZ unit = length > 0.0 ? normal / length : gp_XYZ(0.0, 0.0, 1.0);
+    normals[index * 3] = static_cast<float>(unit.X());
+    normals[index * 3 + 1] = static_cast<float>(unit.Y());
+    normals[index * 3 + 2] = static_cast<float>(unit.Z());
+}
+
+} // anonymous namespace
+
+void MeshNormals::accumulate(FaceResult& result, NormalMode mode) {
+    const size_t nbNodes = result.position.size() / 3;
+    std::vector<gp_XYZ> triangleNormals;
+    std::vector<double> cornerWeights;
+    computeTriangleNormals(result, mode, triangleNormals, cornerWeights);
+
+    std::vector<gp_XYZ> nodeNormals(nbNodes, gp_XYZ(0.0, 0.0, 0.0));
+    for (size_t corner = 0; corner < result.index.size(); corner++) {
+        nodeNormals[result.index[corner]] += triangleNormals[corner / 3] * cornerWeights[corner];
+    }
+
+    result.normal.assign(nbNodes * 3, 0.0f);
+    for (size_t node = 0; node < nbNodes; node++) {
+        setNormal(result.normal, node, nodeNormals[node]);
+    }
+}
+
+void MeshNormals::splitCreases(FaceResult& result, NormalMode mode, double creaseAngle) {
+    const size_t nbNodes = result.position.size() / 3;
+    const size_t nbCorners = result.index.size();
+    const bool hasUV = result.uv.size() == nbNodes * 2;
+    const double cosCrease = std::cos(creaseAngle);
+
+    std::vector<gp_XYZ> triangleNormals;
+    std::vector<double> cornerWeights;
+    computeTriangleNormals(result, mode, triangleNormals, cornerWeights);
+
+    // 节点 -> 所在三角形角的邻接表（CSR）
+    std::vector<uint32_t> offsets(nbNodes + 1, 0);
+    for (uint32_t node : result.index) {
+        offsets[node + 1]++;
+    }
+    for (size_t i = 0; i < nbNodes; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    std::vector<uint32_t> corners(nbCorners);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (uint32_t corner = 0; corner < nbCorners; corner++) {
+        corners[cursor[result.index[corner]]++] = corner;
+    }
+
+    result.normal.assign(nbNodes * 3, 0.0f);
+    std::vector<std::pair<gp_XYZ, uint32_t>> splits;
+    for (uint32_t node = 0; node < nbNodes; node++) {
+        splits.clear();
+        if (offsets[node] == offsets[node + 1]) {
+            setNormal(result.normal, node, gp_XYZ(0.0, 0.0, 0.0));
+            continue;
+        }
+        for (uint32_t i = offsets[node]; i < offsets[node + 1]; i++) {
+            const uint32_t corner = corners[i];
+            const gp_XYZ& ownNormal = triangleNormals[corner / 3];
+
+            // 只累加与当前三角形夹角不超过 creaseAngle 的相邻三角形
+            gp_XYZ normal(0.0, 0.0, 0.0);
+            for (uint32_t j = offsets[node]; j < offsets[node + 1]; j++) {
+                const uint32_t other = corners[j];
+                if (ownNormal.Dot(triangleNormals[other / 3]) >= cosCrease) {
+                    normal += triangleNormals[other / 3] * cornerWeights[other];
+                }
+            }
+            const double length = normal.Modulus();
+            normal = length > 0.0 ? normal / length : ownNormal;
+
+            uint32_t target = node;
+            bool found = false;
+            for (const auto& split : splits) {
+                if (split.first.Dot(normal) > 1.0 - 1e-6) {
+                    target = split.second;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                if (!splits.empty()) {
+                    target = static_cast<uint32_t>(result.position.size() / 3);
+                    const gp_XYZ position = nodeAt(result.position, node);
+                    result.position.push_back(static_cast<float>(position.X()));
+                    result.position.push_back(static_cast<float>(position.Y()));
+                    result.position.push_back(static_cast<float>(position.Z()));
+                    if (hasUV) {
+                        const float u = result.uv[node * 2];
+                        const float v = result.uv[node * 2 + 1];
+                        result.uv.push_back(u);
+                        result.uv.push_back(v);
+                    }
+                    result.normal.resize(result.normal.size() + 3);
+                }
+                splits.emplace_back(normal, target);
+                setNormal(result.normal, target, normal);
+            }
+            result.index[corner] = target;
+        }
+    }
+}
+
+bool MeshNormals::fromSurface(const TopoDS_Face& face, FaceResult& result) {
+    TopLoc_Location loc;
+    const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, loc);
+    if (triangulation.IsNull() || !triangulation->HasUVNodes() || BRep_Tool::Surface(face).IsNull()) {
+        return false;
+    }
+
+    // 极点等退化位置没有曲面法线，先用累加法线兜底
+    MeshNormals::accumulate(result, NormalMode::Angle);
+
+    // BRepAdaptor_Surface 已包含面的位置变换；镜像变换下叉积方向随之翻转
+    const Standard_Boolean isMirrored = loc.Transformation().VectorialPart().Determinant() < 0;
+    const Standard_Boolean isFlipped = (face.Orientation() == TopAbs_REVERSED) ^ isMirrored;
+    BRepAdaptor_Surface surface(face, Standard_False);
+
+    const Standard_Integer nbNodes = triangulation->NbNodes();
+    for (Standard_Integer i = 1; i <= nbNodes; i++) {
+        const gp_Pnt2d uv = triangulation->UVNode(i);
+        gp_Pnt pnt;
+        gp_Vec d1u, d1v;
+        surface.D1(uv.X(), uv.Y(), pnt, d1u, d1v);
+        gp_Vec normal = d1u.Crossed(d1v);
+        const double length = normal.Magnitude();
+        if (length <= Precision::Confusion()) {
+            continue;
+        }
+        normal /= isFlipped ? -length : length;
+        const size_t offset = static_cast<size_t>(i - 1) * 3;
+        result.normal[offset] = static_cast<float>(normal.X());
+        result.normal[offset + 1] = static_cast<float>(normal.Y());
+        result.normal[offset + 2] = static_cast<float>(normal.Z());
+    }
+    return true;
+}
+
+// ==================== PackedMesh ====================
+
+void PackedMesh::appendFace(const TopoDS_Face& face, const FaceResult& faceResult) {
+    const uint32_t faceIndex = static_cast<uint32_t>(faces.size());
+    const uint32_t vertexStart = static_cast<uint32_t>(position.size() / 3);
+    const uint32_t vertexCount = static_cast<uint32_t>(faceResult.position.size() / 3);
+    const uint32_t indexStart = static_cast<uint32_t>(index.size());
+    const uint32_t indexCount = static_cast<uint32_t>(faceResult.index.size());
+
+    position.insert(position.end(), faceResult.position.begin(), faceResult.position.end());
+
+    // normal / uv 与 position 一一对应，缺失时补 0 保证各缓冲对齐
+    if (faceResult.normal.size() == faceResult.position.size()) {
+        normal.insert(normal.end(), faceResult.normal.begin(), faceResult.normal.end());
+    } else {
+        normal.resize(normal.size() + vertexCount * 3, 0.0f);
+    }
+    if (faceResult.uv.size() == vertexCount * 2) {
+        uv.insert(uv.end(), faceResult.uv.begin(), faceResult.uv.end());
+    } else {
+        uv.resize(uv.size() + vertexCount * 2, 0.0f);
+    }
+
+    for (uint32_t i : faceResult.index) {
+        index.push_back(vertexStart + i);
+    }
+    triangleFace.insert(triangleFace.end(), indexCount / 3, faceIndex);
+    faceRange.insert(faceRange.end(), { indexStart, indexCount, vertexStart, vertexCount });
+    faces.push_back(face);
+}
+
+void PackedMesh::appendEdge(const TopoDS_Edge& edge, const EdgeResult& polyline) {
+    const uint32_t vertexStart = static_cast<uint32_t>(edgePosition.size() / 3);
+    const size_t nbPoints = polyline.position.size() / 3;
+    if (nbPoints < 2) {
+        return;
+    }
+
+    // 折线转为 LineSegments：p0 p1, p1 p2, ...
+    edgePosition.reserve(edgePosition.size() + (nbPoints - 1) * 6);
+    for (size_t i = 0; i + 1 < nbPoints; i++) {
+        edgePosition.insert(edgePosition.end(),
+            polyline.position.begin() + i * 3, polyline.position.begin() + i * 3 + 6);
+    }
+
+    edgeRange.insert(edgeRange.end(), { vertexStart, static_cast<uint32_t>((nbPoints - 1) * 2) });
+    edgeType.push_back(static_cast<uint32_t>(Edge::getCurveType(edge)));
+    edges.push_back(edge);
+}
+
+void PackedMesh::appendFaceFrom(const PackedMesh& source, uint32_t sourceIndex, const TopoDS_Face& face) {
+    const uint32_t sourceIndexStart = source.faceRange[sourceIndex * 4];
+    const uint32_t indexCount = source.faceRange[sourceIndex * 4 + 1];
+    const uint32_t sourceVertexStart = source.faceRange[sourceIndex * 4 + 2];
+    const uint32_t vertexCount = source.faceRange[sourceIndex * 4 + 3];
+    const bool isFlipped = face.Orientation() != source.faces[sourceIndex].Orientation();
+
+    const uint32_t faceIndex = static_cast<uint32_t>(faces.size());
+    const uint32_t vertexStart = static_cast<uint32_t>(position.size() / 3);
+    const uint32_t indexStart = static_cast<uint32_t>(index.size());
+
+    position.insert(position.end(),
+        source.position.begin() + sourceVertexStart * 3, source.position.begin() + (sourceVertexStart + vertexCount) * 3);
+    uv.insert(uv.end(),
+        source.uv.begin() + sourceVertexStart * 2, source.uv.begin() + (sourceVertexStart + vertexCount) * 2);
+    const size_t normalStart = normal.size();
+    normal.insert(normal.end(),
+        source.normal.begin() + sourceVertexStart * 3, source.normal.begin() + (sourceVertexStart + vertexCount) * 3);
+    if (isFlipped) {
+        for (size_t i = normalStart; i < normal.size(); i++) {
+            normal[i] = -normal[i];
+        }
+    }
+
+    for (uint32_t t = 0; t < indexCount; t += 3) {
+        const uint32_t* triangle = &source.index[sourceIndexStart + t];
+        index.push_back(triangle[0] - sourceVertexStart + vertexStart);
+        index.push_back(triangle[isFlipped ? 2 : 1] - sourceVertexStart + vertexStart);
+        index.push_back(triangle[isFlipped ? 1 : 2] - sourceVertexStart + vertexStart);
+    }
+    triangleFace.insert(triangleFace.end(), indexCount / 3, faceIndex);
+    faceRange.insert(faceRange.end(), { indexStart, indexCount, vertexStart, vertexCount });
+    faces.push_back(face);
+}
+
+void PackedMesh::appendEdgeFrom(const PackedMesh& source, uint32_t sourceIndex, const TopoDS_Edge& edge) {
+    const uint32_t sourceVertexStart = source.edgeRange[sourceIndex * 2];
+    const uint32_t vertexCount = source.edgeRange[sourceIndex * 2 + 1];
+    const uint32_t vertexStart = static_cast<uint32_t>(edgePosition.size() / 3);
+
+    edgePosition.insert(edgePosition.end(),
+        source.edgePosition.begin() + sourceVertexStart * 3, source.edgePosition.begin() + (sourceVertexStart + vertexCount) * 3);
+    edgeRange.insert(edgeRange.end(), { vertexStart, vertexCount });
+    edgeType.push_back(source.edgeType[sourceIndex]);
+    edges.push_back(edge);
+}
+
+// ==================== QuantizedMesh ====================
+
+namespace {
+
+// 八面体编码，输入为单位向量，输出分量位于 [-1, 1]
+void octahedralEncode(float x, float y, float z, float& u, float& v) {
+    const float sum = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if (sum <= 0.0f) {
+        u = 0.0f;
+        v = 0.0f;
+        return;
+    }
+    u = x / sum;
+    v = y / sum;
+    if (z < 0.0f) {
+        const float pu = u;
+        u = (1.0f - std::fabs(v)) * (pu >= 0.0f ? 1.0f : -1.0f);
+        v = (1.0f - std::fabs(pu)) * (v >= 0.0f ? 1.0f : -1.0f);
+    }
+}
+
+template<typename T>
+void encodeNormals(const std::vector<float>& normals, std::vector<T>& encoded) {
+    const float maxValue = static_cast<float>(std::numeric_limits<T>::max());
+    encoded.resize(normals.size() / 3 * 2);
+    for (size_t i = 0, j = 0; i + 2 < normals.size(); i += 3, j += 2) {
+        float u, v;
+        octahedralEncode(normals[i], normals[i + 1], normals[i + 2], u, v);
+        encoded[j] = static_cast<T>(std::lround(u * maxValue));
+        encoded[j + 1] = static_cast<T>(std::lround(v * maxValue));
+    }
+}
+
+void quantizePositions(const std::vector<float>& positions, const float* min, const float* scale, std::vector<uint16_t>& quantized) {
+    quantized.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        const int axis = static_cast<int>(i % 3);
+        const float value = scale[axis] > 0.0f ? (positions[i] - min[axis]) / scale[axis] : 0.0f;
+        quantized[i] = static_cast<uint16_t>(std::lround(std::min(std::max(value, 0.0f), 65535.0f)));
+    }
+}
+
+/**
+ * 返回的 TypedArray 均为 quantized 在 wasm 堆上内存的视图，quantized.delete() 后失效。
+ * faces / edges / parts 的句柄先于视图创建，避免堆分配导致内存增长使视图失效
+ */
+val quantizedMeshToObject(const QuantizedMesh& quantized) {
+    val obj = val::object();
+    obj.set("faces", topoVectorToArray(quantized.faces));
+    obj.set("edges", topoVectorToArray(quantized.edges));
+    obj.set("parts", topoVectorToArray(quantized.parts));
+    obj.set("position", toMemoryView(quantized.position));
+    if (quantized.normalBits == 8) {
+        obj.set("normal", toMemoryView(quantized.normal8));
+    } else {
+        obj.set("normal", toMemoryView(quantized.normal16));
+    }
+    obj.set("normalBits", quantized.normalBits);
+    obj.set("uv", toMemoryView(quantized.uv));
+    if (quantized.index32.empty()) {
+        obj.set("index", toMemoryView(quantized.index16));
+    } else {
+        obj.set("index", toMemoryView(quantized.index32));
+    }
+    obj.set("faceRange", toMemoryView(quantized.faceRange));
+    obj.set("triangleFace", toMemoryView(quantized.triangleFace));
+    obj.set("edgePosition", toMemoryView(quantized.edgePosition));
+    obj.set("edgeRange", toMemoryView(quantized.edgeRange));
+    obj.set("edgeType", toMemoryView(quantized.edgeType));
+    obj.set("partRange", toMemoryView(quantized.partRange));
+    obj.set("decodeMatrix", toMemoryView(quantized.decodeMatrix, 16));
+    return obj;
+}
+
+} // anonymous namespace
+
+// ==================== MeshCache ====================
+
+namespace {
+
+// 检查只比较 lineDeflection，键中不含 angleDeviation
+using MeshCacheKey = std::pair<const TopoDS_TShape*, double>;
+
+// 记录的键数上限，超出时整体清空重新计数
+constexpr size_t MAX_MESH_CACHE_KEYS = 4096;
+
+/**
+ * 三角化本身挂在 TShape 上，这里只记录本缓存划分或确认过的键，用于区分 hits 和 reuses。
+ * 不持有 shape，TShape 释放后指针可能被复用，影响的只是统计归类，是否重划始终由 BRepTools::Triangulation 判断
+ */
+struct MeshCacheState {
+    std::set<MeshCacheKey> keys;
+    MeshCacheStats stats { 0, 0, 0, 0 };
+
+    void remember(const MeshCacheKey& key) {
+        if (keys.size() >= MAX_MESH_CACHE_KEYS) {
+            keys.clear();
+        }
+        keys.insert(key);
+    }
+};
+
+MeshCacheState& meshCacheState() {
+    static MeshCacheState state;
+    return state;
+}
+
+MeshCacheKey makeKey(const TopoDS_Shape& shape, const MeshOptions& options) {
+    return MeshCacheKey(shape.TShape().get(), options.lineDeflection);
+}
+
+/** 已有满足精度的三角化时记录命中并返回 true，否则记录未命中 */
+bool lookupTriangulation(MeshCacheState& state, const TopoDS_Shape& shape, const MeshOptions& options) {
+    const MeshCacheKey key = makeKey(shape, options);
+
+    // 三角化挂在 TShape 上，可能被其他调用清除或替换，命中时仍需确认
+    const bool isAdequate = BRepTools::Triangulation(shape, options.lineDeflection, Standard_True);
+    if (isAdequate) {
+        if (state.keys.count(key) > 0) {
+            state.stats.hits++;
+        } else {
+            state.stats.reuses++;
+            state.remember(key);
+        }
+        return true;
+    }
+    state.stats.misses++;
+    return false;
+}
+
+} // anonymous namespace
+
+bool MeshCache::ensureTriangulation(const TopoDS_Shape& shape, const MeshOptions& options) {
+    if (shape.IsNull()) {
+        return false;
+    }
+
+    MeshCacheState& state = meshCacheState();
+    if (lookupTriangulation(state, shape, options)) {
+        return false;
+    }
+
+    BRepMesh_IncrementalMesh mesher(shape, options.lineDeflection, options.parallel ? Standard_True : Standard_False,
+        options.angleDeviation, Standard_True);
+    state.remember(makeKey(shape, options));
+    return true;
+}
+
+bool MeshCache::ensureTriangulation(const std::vector<TopoDS_Shape>& shapes, const MeshOptions& options) {
+    MeshCacheState& state = meshCacheState();
+
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    std::vector<const TopoDS_Shape*> pending;
+    for (const TopoDS_Shape& shape : shapes) {
+        if (shape.IsNull() || lookupTriangulation(state, shape, options)) {
+            continue;
+        }
+        builder.Add(compound, shape);
+        pending.push_back(&shape);
+    }
+    if (pending.empty()) {
+        return false;
+    }
+
+    // 所有零件的面进入同一个 BRepMesh 模型，parallel 时由线程池并行划分
+    BRepMesh_IncrementalMesh mesher(compound, options.lineDeflection, options.parallel ? Standard_True : Standard_False,
+        options.angleDeviation, Standard_True);
+    for (const TopoDS_Shape* shape : pending) {
+        state.remember(makeKey(*shape, options));
+    }
+    return true;
+}
+
+void MeshCache::invalidate(const TopoDS_Shape& shape) {
+    if (shape.IsNull()) {
+        return;
+    }
+    MeshCacheState& state = meshCacheState();
+    const TopoDS_TShape* tshape = shape.TShape().get();
+    auto it = state.keys.lower_bound(MeshCacheKey(tshape, -std::numeric_limits<double>::infinity()));
+    while (it != state.keys.end() && it->first == tshape) {
+        it = state.keys.erase(it);
+    }
+    BRepTools::Clean(shape);
+}
+
+void MeshCache::clear() {
+    meshCacheState().keys.clear();
+}
+
+MeshCacheStats MeshCache::getStats() {
+    MeshCacheState& state = meshCacheState();
+    MeshCacheStats stats = state.stats;
+    stats.entries = static_cast<uint32_t>(state.keys.size());
+    return stats;
+}
+
+void MeshCache::resetStats() {
+    meshCacheState().stats = MeshCacheStats { 0, 0, 0, 0 };
+}
+
+// ==================== Mesher ====================
+
+namespace {
+
+void reservePackedFaces(PackedMesh& packed, const std::vector<TopoDS_Face>& faces) {
+    size_t nbNodes = 0;
+    size_t nbTriangles = 0;
+    for (const TopoDS_Face& face : faces) {
+        TopLoc_Location loc;
+        const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, loc);
+        if (triangulation.IsNull()) {
+            continue;
+        }
+        nbNodes += triangulation->NbNodes();
+        nbTriangles += triangulation->NbTriangles();
+    }
+    packed.position.reserve(packed.position.size() + nbNodes * 3);
+    packed.normal.reserve(packed.normal.size() + nbNodes * 3);
+    packed.uv.reserve(packed.uv.size() + nbNodes * 2);
+    packed.index.reserve(packed.index.size() + nbTriangles * 3);
+    packed.triangleFace.reserve(packed.triangleFace.size() + nbTriangles);
+    packed.faceRange.reserve(packed.faceRange.size() + faces.size() * 4);
+    packed.faces.reserve(packed.faces.size() + faces.size());
+}
+
+/**
+ * 返回的 TypedArray 均为 packed 在 wasm 堆上内存的视图，packed.delete() 后失效。
+ * faces / edges / parts 的句柄会在堆上分配，先于视图创建，避免内存增长使视图失效
+ */
+val packedMeshToObject(const PackedMesh& packed) {
+    val obj = val::object();
+    obj.set("faces", topoVectorToArray(packed.faces));
+    obj.set("edges", topoVectorToArray(packed.edges));
+    obj.set("parts", topoVectorToArray(packed.parts));
+    obj.set("position", toMemoryView(packed.position));
+    obj.set("normal", toMemoryView(packed.normal));
+    obj.set("uv", toMemoryView(packed.uv));
+    obj.set("index", toMemoryView(packed.index));
+    obj.set("faceRange", toMemoryView(packed.faceRange));
+    obj.set("triangleFace", toMemoryView(packed.triangleFace));
+    obj.set("edgePosition", toMemoryView(packed.edgePosition));
+    obj.set("edgeRange", toMemoryView(packed.edgeRange));
+    obj.set("edgeType", toMemoryView(packed.edgeType));
+    obj.set("partRange", toMemoryView(packed.partRange));
+    return obj;
+}
+
+/** 读取已有三角化填充 packed，faces / edges 由调用方遍历一次后复用 */
+void fillPackedMesh(PackedMesh& packed, const std::vector<TopoDS_Face>& faces, const std::vector<TopoDS_Edge>& edges,
+    const MeshOptions& options) {
+    reservePackedFaces(packed, faces);
+    for (const TopoDS_Face& face : faces) {
+        FaceResult faceResult = Face::readTriangulation(face, options);
+        if (faceResult.position.empty() || faceResult.index.empty()) {
+            continue;
+        }
+        packed.appendFace(face, faceResult);
+    }
+
+    packed.edges.reserve(packed.edges.size() + edges.size());
+    for (const TopoDS_Edge& edge : edges) {
+        if (BRep_Tool::Degenerated(edge)) {
+            continue;
+        }
+        packed.appendEdge(edge, Edge::readPolyline(edge, options.lineDeflection, options.angleDeviation));
+    }
+}
+
+void collectNodeShapes(const ShapeNode& node, std::vector<TopoDS_Shape>& shapes) {
+    if (node.shape.has_value() && !node.shape->IsNull()) {
+        shapes.push_back(*node.shape);
+    }
+    for (const ShapeNode& child : node.children) {
+        collectNodeShapes(child, shapes);
+    }
+}
+
+/** 按 source 的子形状顺序取出 copier 中对应的副本，保持原有朝向 */
+template<typename T>
+std::vector<T> copiedSubShapes(const BRepBuilderAPI_Copy& copier, const std::vector<T>& source,
+    TopTools_DataMapOfShapeShape& copyToSource) {
+    std::vector<T> copies;
+    copies.reserve(source.size());
+    for (const T& shape : source) {
+        const TopoDS_Shape copy = copier.ModifiedShape(shape).Oriented(shape.Orientation());
+        copyToSource.Bind(copy, shape);
+        copies.push_back(static_cast<const T&>(copy));
+    }
+    return copies;
+}
+
+} // anonymous namespace
+
+PackedMesh Mesher::toPackedMesh(const TopoDS_Shape& shape, const MeshOptions& options) {
+    PackedMesh packed;
+    if (shape.IsNull()) {
+        return packed;
+    }
+
+    MeshCache::ensureTriangulation(shape, options);
+    fillPackedMesh(packed, Shape::getFaces(shape), Shape::getEdges(shape), options);
+    return packed;
+}
+
+PackedMesh Mesher::toPackedShapes(const std::vector<TopoDS_Shape>& shapes, const MeshOptions& options) {
+    PackedMesh packed;
+    MeshCache::ensureTriangulation(shapes, options);
+
+    packed.parts.reserve(shapes.size());
+    packed.partRange.reserve(shapes.size() * 4);
+    for (const TopoDS_Shape& shape : shapes) {
+        const uint32_t faceStart = static_cast<uint32_t>(packed.faces.size());
+        const uint32_t edgeStart = static_cast<uint32_t>(packed.edges.size());
+        if (!shape.IsNull()) {
+            fillPackedMesh(packed, Shape::getFaces(shape), Shape::getEdges(shape), options);
+        }
+        packed.partRange.insert(packed.partRange.end(), {
+            faceStart, static_cast<uint32_t>(packed.faces.size()) - faceStart,
+            edgeStart, static_cast<uint32_t>(packed.edges.size()) - edgeStart,
+        });
+        packed.parts.push_back(shape);
+    }
+    return packed;
+}
+
+PackedMesh Mesher::toPackedAssembly(const ShapeNode& root, const MeshOptions& options) {
+    std::vector<TopoDS_Shape> shapes;
+    collectNodeShapes(root, shapes);
+    return Mesher::toPackedShapes(shapes, options);
+}
+
+void Mesher::streamPackedMesh(const TopoDS_Shape& shape, const MeshOptions& options, uint32_t batchFaces,
+    const val& callback) {
+    MeshStream stream(shape, options);
+    while (!stream.isDone()) {
+        val result = callback(stream.next(batchFaces), stream.getProgress());
+        if (result.strictlyEquals(val(false))) {
+            break;
+        }
+    }
+}
+
+std::vector<PackedMesh> Mesher::toPackedLods(const TopoDS_Shape& shape, std::vector<double> deflections, const MeshOptions& options) {
+    std::vector<PackedMesh> levels;
+    deflections.erase(std::remove_if(deflections.begin(), deflections.end(),
+        [](double deflection) { return !(deflection > 0.0); }), deflections.end());
+    if (shape.IsNull() || deflections.empty()) {
+        return levels;
+    }
+
+    std::sort(deflections.begin(), deflections.end(), std::greater<double>());
+    deflections.erase(std::unique(deflections.begin(), deflections.end()), deflections.end());
+
+    // 在不共享 TShape 的几何副本上由粗到细划分：已有三角化比要求粗时 BRepMesh 会自行重划，无需 Clean，
+    // 调用方 shape 及与其共享几何的 shape 上的三角化保持不变
+    BRepBuilderAPI_Copy copier(shape, Standard_True, Standard_False);
+    TopTools_DataMapOfShapeShape copyToSource;
+    const std::vector<TopoDS_Face> faces = copiedSubShapes(copier, Shape::getFaces(shape), copyToSource);
+    const std::vector<TopoDS_Edge> edges = copiedSubShapes(copier, Shape::getEdges(shape), copyToSource);
+    const double finest = deflections.back();
+
+    levels.reserve(deflections.size());
+    for (double deflection : deflections) {
+        MeshOptions levelOptions = options;
+        levelOptions.lineDeflection = deflection;
+        levelOptions.angleDeviation = std::min(options.angleDeviation * deflection / finest, 0.5);
+
+        BRepMesh_IncrementalMesh mesher(copier.Shape(), levelOptions.lineDeflection,
+            levelOptions.parallel ? Standard_True : Standard_False, levelOptions.angleDeviation, Standard_True);
+
+        PackedMesh packed;
+        fillPackedMesh(packed, faces, edges, levelOptions);
+        // 结果中的面和边换回调用方 shape 的子形状
+        for (TopoDS_Face& face : packed.faces) {
+            face = TopoDS::Face(copyToSource.Find(face));
+        }
+        for (TopoDS_Edge& edge : packed.edges) {
+            edge = TopoDS::Edge(copyToSource.Find(edge));
+        }
+        levels.push_back(std::move(packed));
+    }
+    return levels;
+}
+
+QuantizedMesh Mesher::quantize(const PackedMesh& packed, int normalBits) {
+    QuantizedMesh quantized;
+    quantized.normalBits = normalBits == 16 ? 16 : 8;
+
+    // 包围盒取自面与边的全部顶点，比 shape 的 Bnd_Box 更紧
+    float min[3] = { 0.0f, 0.0f, 0.0f };
+    float max[3] = { 0.0f, 0.0f, 0.0f };
+    bool isEmpty = true;
+    for (const std::vector<float>* positions : { &packed.position, &packed.edgePosition }) {
+        for (size_t i = 0; i + 2 < positions->size(); i += 3) {
+            for (int axis = 0; axis < 3; axis++) {
+                const float value = (*positions)[i + axis];
+                min[axis] = isEmpty ? value : std::min(min[axis], value);
+                max[axis] = isEmpty ? value : std::max(max[axis], value);
+            }
+            isEmpty = false;
+        }
+    }
+    float scale[3];
+    for (int axis = 0; axis < 3; axis++) {
+        scale[axis] = (max[axis] - min[axis]) / 65535.0f;
+    }
+
+    std::fill(std::begin(quantized.decodeMatrix), std::end(quantized.decodeMatrix), 0.0f);
+    quantized.decodeMatrix[0] = scale[0];
+    quantized.decodeMatrix[5] = scale[1];
+    quantized.decodeMatrix[10] = scale[2];
+    quantized.decodeMatrix[12] = min[0];
+    quantized.decodeMatrix[13] = min[1];
+    quantized.decodeMatrix[14] = min[2];
+    quantized.decodeMatrix[15] = 1.0f;
+
+    quantizePositions(packed.position, min, scale, quantized.position);
+    quantizePositions(packed.edgePosition, min, scale, quantized.edgePosition);
+
+    if (quantized.normalBits == 8) {
+        encodeNormals(packed.normal, quantized.normal8);
+    } else {
+        encodeNormals(packed.normal, quantized.normal16);
+    }
+
+    if (packed.position.size() / 3 < 65536) {
+        quantized.index16.assign(packed.index.begin(), packed.index.end());
+    } else {
+        quantized.index32 = packed.index;
+    }
+
+    quantized.uv = packed.uv;
+    quantized.faceRange = packed.faceRange;
+    quantized.triangleFace = packed.triangleFace;
+    quantized.faces = packed.faces;
+    quantized.edgeRange = packed.edgeRange;
+    quantized.edgeType = packed.edgeType;
+    quantized.edges = packed.edges;
+    quantized.partRange = packed.partRange;
+    quantized.parts = packed.parts;
+    return quantized;
+}
+
+PackedMesh Mesher::retessellate(const TopoDS_Shape& shape, const PackedMesh& previous, const MeshOptions& options) {
+    PackedMesh packed;
+    if (shape.IsNull()) {
+        return packed;
+    }
+
+    // 保留下来的面仍挂着原三角化，BRepMesh_IncrementalMesh 只会划分新面
+    MeshCache::ensureTriangulation(shape, options);
+
+    TopTools_DataMapOfShapeInteger previousFaces;
+    for (size_t i = 0; i < previous.faces.size(); i++) {
+        previousFaces.Bind(previous.faces[i], static_cast<Standard_Integer>(i));
+    }
+    TopTools_DataMapOfShapeInteger previousEdges;
+    for (size_t i = 0; i < previous.edges.size(); i++) {
+        previousEdges.Bind(previous.edges[i], static_cast<Standard_Integer>(i));
+    }
+
+    std::vector<TopoDS_Face> faces = Shape::getFaces(shape);
+    reservePackedFaces(packed, faces);
+    for (const TopoDS_Face& face : faces) {
+        if (const Standard_Integer* sourceIndex = previousFaces.Seek(face)) {
+            packed.appendFaceFrom(previous, static_cast<uint32_t>(*sourceIndex), face);
+            continue;
+        }
+        FaceResult faceResult = Face::readTriangulation(face, options);
+        if (faceResult.position.empty() || faceResult.index.empty()) {
+            continue;
+        }
+        packed.appendFace(face, faceResult);
+    }
+
+    std::vector<TopoDS_Edge> edges = Shape::getEdges(shape);
+    packed.edges.reserve(edges.size());
+    for (const TopoDS_Edge& edge : edges) {
+        if (BRep_Tool::Degenerated(edge)) {
+            continue;
+        }
+        if (const Standard_Integer* sourceIndex = previousEdges.Seek(edge)) {
+            packed.appendEdgeFrom(previous, static_cast<uint32_t>(*sourceIndex), edge);
+            continue;
+        }
+        packed.appendEdge(edge, Edge::readPolyline(edge, options.lineDeflection, options.angleDeviation));
+    }
+
+    return packed;
+}
+
+#ifdef OCCT_WASM_THREADS
+namespace {
+
+/**
+ * 主线程无法等待新 Worker 启动，线程数超过预先创建的 Worker 时会卡死，
+ * 因此限制在 OCCT_WASM_PTHREAD_POOL_SIZE 以内，count <= 0 时取逻辑核数
+ */
+int clampThreadCount(int count) {
+    if (count <= 0) {
+        count = emscripten_num_logical_cores();
+    }
+    return std::min(std::max(count, 1), OCCT_WASM_PTHREAD_POOL_SIZE);
+}
+
+} // anonymous namespace
+#endif
+
+int Mesher::setThreadCount(int count) {
+#ifdef OCCT_WASM_THREADS
+    OSD_ThreadPool::DefaultPool()->Init(clampThreadCount(count));
+    return OSD_ThreadPool::DefaultPool()->NbThreads();
+#else
+    (void)count;
+    return 1;
+#endif
+}
+
+int Mesher::getThreadCount() {
+#ifdef OCCT_WASM_THREADS
+    return OSD_ThreadPool::DefaultPool()->NbThreads();
+#else
+    return 1;
+#endif
+}
+
+void Mesher::setParallel(bool parallel) {
+    parallelDefault() = parallel;
+}
+
+bool Mesher::isParallel() {
+    return parallelDefault();
+}
+
+// ==================== MeshStream ====================
+
+namespace {
+
+/** 用包围盒两两边长乘积的最大值估计面积，避免逐面做曲面积分 */
+double estimateFaceArea(const TopoDS_Face& face) {
+    Bnd_Box box;
+    BRepBndLib::Add(face, box, Standard_False);
+    if (box.IsVoid()) {
+        return 0.0;
+    }
+    double xMin, yMin, zMin, xMax, yMax, zMax;
+    box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    const double dx = xMax - xMin;
+    const double dy = yMax - yMin;
+    const double dz = zMax - zMin;
+    return std::max({ dx * dy, dy * dz, dz * dx });
+}
+
+} // anonymous namespace
+
+MeshStream::MeshStream(const TopoDS_Shape& shape_, const MeshOptions& options_)
+    : shape(shape_), options(options_), isMeshed(false), cursor(0) {
+    if (shape.IsNull()) {
+        return;
+    }
+    isMeshed = BRepTools::Triangulation(shape, options.lineDeflection, Standard_True);
+
+    std::vector<std::pair<double, TopoDS_Face>> ordered;
+    for (const TopoDS_Face& face : Shape::getFaces(shape)) {
+        ordered.emplace_back(estimateFaceArea(face), face);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(),
+        [](const auto& a, const auto& b) { return a.first > b.first; });
+    faces.reserve(ordered.size());
+    for (auto& entry : ordered) {
+        faces.push_back(std::move(entry.second));
+    }
+
+    TopExp::MapShapesAndAncestors(shape, TopAbs_EDGE, TopAbs_FACE, edgeFaces);
+}
+
+PackedMesh MeshStream::next(uint32_t maxFaces) {
+    PackedMesh chunk;
+    if (isDone()) {
+        return chunk;
+    }
+    const size_t end = std::min(faces.size(), cursor + std::max<uint32_t>(maxFaces, 1));
+    const std::vector<TopoDS_Face> batch(faces.begin() + cursor, faces.begin() + end);
+    cursor = end;
+
+    if (!isMeshed) {
+        BRep_Builder builder;
+        TopoDS_Compound compound;
+        builder.MakeCompound(compound);
+        TopTools_MapOfShape added;
+        for (const TopoDS_Face& face : batch) {
+            if (added.Add(face)) {
+                builder.Add(compound, face);
+            }
+            // 已划分的相邻面带入同一模型，BRepMesh 从其三角化中提取公共边的离散
+            for (TopExp_Explorer exp(face, TopAbs_EDGE); exp.More(); exp.Next()) {
+                const TopTools_ListOfShape* neighbours = edgeFaces.Seek(exp.Current());
+                if (neighbours == nullptr) {
+                    continue;
+                }
+                for (const TopoDS_Shape& neighbour : *neighbours) {
+                    if (meshedFaces.Contains(neighbour) && added.Add(neighbour)) {
+                        builder.Add(compound, neighbour);
+                    }
+                }
+            }
+        }
+        BRepMesh_IncrementalMesh mesher(compound, options.lineDeflection, options.parallel ? Standard_True : Standard_False,
+            options.angleDeviation, Standard_True);
+    }
+    for (const TopoDS_Face& face : batch) {
+        meshedFaces.Add(face);
+    }
+
+    std::vector<TopoDS_Edge> edges;
+    for (const TopoDS_Face& face : batch) {
+        for (TopExp_Explorer exp(face, TopAbs_EDGE); exp.More(); exp.Next()) {
+            if (emittedEdges.Add(exp.Current())) {
+                edges.push_back(TopoDS::Edge(exp.Current()));
+            }
+        }
+    }
+    fillPackedMesh(chunk, batch, edges, options);
+
+    if (isDone()) {
+        // 整体登记到缓存，之后的 toPackedMesh 等调用直接命中
+        MeshCache::ensureTriangulation(shape, options);
+    }
+    return chunk;
+}
+
+bool MeshStream::isDone() const {
+    return cursor >= faces.size();
+}
+
+double MeshStream::getProgress() const {
+    return faces.empty() ? 1.0 : static_cast<double>(cursor) / static_cast<double>(faces.size());
+}
+
+namespace MeshBindings {
+
+void registerBindings() {
+#ifdef OCCT_WASM_THREADS
+    // 默认线程池首次使用时按逻辑核数创建，可能超过 Worker 数，这里提前按限制后的线程数创建
+    OSD_ThreadPool::DefaultPool(clampThreadCount(0));
+#endif
+
+    class_<PackedMesh>("PackedMesh")
+        .function("toObject", &packedMeshToObject)
+        .function("getFaceCount", optional_override([](const PackedMesh& self) {
+            return self.faces.size();
+        }))
+        .function("getEdgeCount", optional_override([](const PackedMesh& self) {
+            return self.edges.size();
+        }))
+        .function("getPartCount", optional_override([](const PackedMesh& self) {
+            return self.parts.size();
+        }));
+
+    class_<QuantizedMesh>("QuantizedMesh")
+        .function("toObject", &quantizedMeshToObject)
+        .function("getFaceCount", optional_override([](const QuantizedMesh& self) {
+            return self.faces.size();
+        }))
+        .function("getEdgeCount", optional_override([](const QuantizedMesh& self) {
+            return self.edges.size();
+        }));
+
+    value_object<MeshCacheStats>("MeshCacheStats")
+        .field("hits", &MeshCacheStats::hits)
+        .field("reuses", &MeshCacheStats::reuses)
+        .field("misses", &MeshCacheStats::misses)
+        .field("entries", &MeshCacheStats::entries);
+
+    class_<MeshCache>("MeshCache")
+        .class_function("invalidate", &MeshCache::invalidate)
+        .class_function("clear", &MeshCache::clear)
+        .class_function("getStats", &MeshCache::getStats)
+        .class_function("resetStats", &MeshCache::resetStats);
+
+    class_<MeshStream>("MeshStream")
+        .function("next", &MeshStream::next)
+        .function("isDone", &MeshStream::isDone)
+        .function("getProgress", &MeshStream::getProgress);
+
+    class_<Mesher>("Mesher")
+        .class_function("toPackedMesh", optional_override([](const TopoDS_Shape& shape, const val& options) {
+            return Mesher::toPackedMesh(shape, MeshOptions::fromVal(options));
+        }))
+        .class_function("toPackedShapes", optional_override([](const TopoShapeArray& shapes, const val& options) {
+            return Mesher::toPackedShapes(vecFromJSArray<TopoDS_Shape>(shapes), MeshOptions::fromVal(options));
+        }))
+        .class_function("toPackedAssembly", optional_override([](const ShapeNode& root, const val& options) {
+            return Mesher::toPackedAssembly(root, MeshOptions::fromVal(options));
+        }))
+        .class_function("createStream", optional_override([](const TopoDS_Shape& shape, const val& options) {
+            return MeshStream(shape, MeshOptions::fromVal(options));
+        }))
+        .class_function("streamPackedMesh", optional_override([](const TopoDS_Shape& shape, const val& options, uint32_t batchFaces, const val& callback) {
+            Mesher::streamPackedMesh(shape, MeshOptions::fromVal(options), batchFaces, callback);
+        }))
+        .class_function("toPackedLods", optional_override([](const TopoDS_Shape& shape, const NumberArray& deflections, const val& options) {
+            val levels = val::array();
+            for (PackedMesh& level : Mesher::toPackedLods(shape, vecFromJSArray<double>(deflections), MeshOptions::fromVal(options))) {
+                levels.call<void>("push", val(std::move(level)));
+            }
+            return levels;
+        }))
+        .class_function("quantize", optional_override([](const PackedMesh& packed, const val& options) {
+            int normalBits = 8;
+            if (!options.isUndefined() && !options.isNull() && !options["normalBits"].isUndefined()) {
+                normalBits = options["normalBits"].as<int>();
+            }
+            return Mesher::quantize(packed, normalBits);
+        }))
+        .class_function("retessellate", optional_override([](const TopoDS_Shape& shape, const PackedMesh& previous, const val& options) {
+            return Mesher::retessellate(shape, previous, MeshOptions::fromVal(options));
+        }))
+        .class_function("setThreadCount", &Mesher::setThreadCount)
+        .class_function("getThreadCount", &Mesher::getThreadCount)
+        .class_function("setParallel", &Mesher::setParallel)
+        .class_function("isParallel", &Mesher::isParallel);
+}
+
+} // namespace MeshBindings
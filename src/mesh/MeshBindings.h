@@ -0,0 +1,204 @@
+#ifndef MESH_BINDINGS_H
+#define MESH_BINDINGS_H
+
+#include "shared/Shared.hpp"
+
+#include <TopoDS_Shape.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <vector>
+
+struct EdgeResult;
+struct FaceResult;
+struct ShapeNode;
+
+/**
+ * 顶点法线来源
+ * Surface: 三角化自带法线或在 UV 节点处计算曲面法线，无曲面时退化为 Angle
+ * Angle / Area: 按三角形夹角 / 面积加权累加
+ */
+enum class NormalMode {
+    Surface,
+    Angle,
+    Area,
+};
+
+/**
+ * 网格划分参数，JS 侧传入
+ * { lineDeflection?, angleDeviation?, parallel?, normalMode?: "surface" | "angle" | "area", creaseAngle? }
+ * parallel 仅在多线程版本（occt-wasm-mt）中生效，默认取 Mesher.setParallel 的设置
+ * creaseAngle（弧度）大于 0 时，累加法线会在夹角超过该值的三角形之间拆分顶点
+ */
+struct MeshOptions {
+    double lineDeflection;
+    double angleDeviation;
+    bool parallel;
+    NormalMode normalMode;
+    double creaseAngle;
+
+    MeshOptions(double lineDeflection_ = Constants::LINE_DEFLECTION, double angleDeviation_ = Constants::ANGLE_DEFLECTION);
+
+    static MeshOptions fromVal(const emscripten::val& options);
+};
+
+/**
+ * 整个 shape 打包后的网格，所有面共用一组顶点/索引缓冲，所有边共用一组线段缓冲
+ * faceRange: 每个面 4 个值 [indexStart, indexCount, vertexStart, vertexCount]
+ * triangleFace: 每个三角形所属面在 faces 中的序号，用于拾取
+ * edgeRange: 每条边 2 个值 [vertexStart, vertexCount]，edgePosition 按 LineSegments 排列
+ * partRange: 批量划分时每个零件 4 个值 [faceStart, faceCount, edgeStart, edgeCount]，对应 parts，单个 shape 时为空
+ */
+struct PackedMesh {
+    std::vector<float> position;
+    std::vector<float> normal;
+    std::vector<float> uv;
+    std::vector<uint32_t> index;
+    std::vector<uint32_t> faceRange;
+    std::vector<uint32_t> triangleFace;
+    std::vector<TopoDS_Face> faces;
+
+    std::vector<float> edgePosition;
+    std::vector<uint32_t> edgeRange;
+    std::vector<uint32_t> edgeType;
+    std::vector<TopoDS_Edge> edges;
+
+    std::vector<uint32_t> partRange;
+    std::vector<TopoDS_Shape> parts;
+
+    void appendFace(const TopoDS_Face& face, const FaceResult& faceResult);
+    void appendEdge(const TopoDS_Edge& edge, const EdgeResult& polyline);
+    // 复制 source 中第 sourceIndex 个面/边的数据块，face 与原面朝向相反时翻转绕序和法线
+    void appendFaceFrom(const PackedMesh& source, uint32_t sourceIndex, const TopoDS_Face& face);
+    void appendEdgeFrom(const PackedMesh& source, uint32_t sourceIndex, const TopoDS_Edge& edge);
+};
+
+/**
+ * PackedMesh 的压缩编码
+ * position / edgePosition: 相对包围盒量化的 Uint16，还原为 decodeMatrix * (x, y, z, 1)，decodeMatrix 按列主序
+ * normal: 八面体编码，每个顶点 2 个分量，normalBits 为 8 时存于 normal8，为 16 时存于 normal16
+ * index: 顶点数小于 65536 时存于 index16，否则存于 index32
+ */
+struct QuantizedMesh {
+    std::vector<uint16_t> position;
+    std::vector<int8_t> normal8;
+    std::vector<int16_t> normal16;
+    std::vector<float> uv;
+    std::vector<uint16_t> index16;
+    std::vector<uint32_t> index32;
+    std::vector<uint32_t> faceRange;
+    std::vector<uint32_t> triangleFace;
+    std::vector<TopoDS_Face> faces;
+
+    std::vector<uint16_t> edgePosition;
+    std::vector<uint32_t> edgeRange;
+    std::vector<uint32_t> edgeType;
+    std::vector<TopoDS_Edge> edges;
+
+    std::vector<uint32_t> partRange;
+    std::vector<TopoDS_Shape> parts;
+
+    float decodeMatrix[16];
+    int normalBits;
+};
+
+class MeshNormals {
+public:
+  // 一次遍历三角形累加顶点法线，要求 result.index 已按面朝向排列
+  static void accumulate(FaceResult& result, NormalMode mode);
+  // 累加法线并在折角处拆分顶点，会追加 position / uv 并改写 index
+  static void splitCreases(FaceResult& result, NormalMode mode, double creaseAngle);
+  // 在三角化的 UV 节点处计算曲面法线，面没有曲面或缺少 UV 时返回 false
+  static bool fromSurface(const TopoDS_Face& face, FaceResult& result);
+};
+
+/**
+ * hits: 本缓存划分或确认过的 shape 再次满足精度；reuses: 首次遇到已有足够精细三角化的 shape；
+ * misses: 需要重新划分；entries: 当前记录的键数，不持有 shape，达到上限时清空
+ */
+struct MeshCacheStats {
+    uint32_t hits;
+    uint32_t reuses;
+    uint32_t misses;
+    uint32_t entries;
+};
+
+/**
+ * 三角化缓存，三角化保存在 TShape 上，键为 TShape + lineDeflection。
+ * 命中或 shape 上已有足够精细的 Poly_Triangulation 时跳过 BRepMesh_IncrementalMesh
+ */
+class MeshCache {
+public:
+  // 保证 shape 带有满足精度的三角化，返回 true 表示本次执行了网格划分
+  static bool ensureTriangulation(const TopoDS_Shape& shape, const MeshOptions& options);
+  // 批量版本：未命中的 shape 合并为一个 compound 只划分一次，parallel 时各面分布到线程池
+  static bool ensureTriangulation(const std::vector<TopoDS_Shape>& shapes, const MeshOptions& options);
+  // 移除 shape 相关的缓存项并清除其三角化，下次调用时重新划分
+  static void invalidate(const TopoDS_Shape& shape);
+  static void clear();
+  static MeshCacheStats getStats();
+  static void resetStats();
+};
+
+/**
+ * 渐进式网格划分：按面积估计从大到小，每次 next 划分并返回一批面，以及首次出现的边。
+ * 每批与已划分的相邻面一起交给 BRepMesh，已有三角化的相邻面只复用不重划，批之间的公共边保持一致
+ */
+class MeshStream {
+public:
+  MeshStream(const TopoDS_Shape& shape, const MeshOptions& options);
+
+  // 划分并返回最多 maxFaces 个面，全部完成后返回空 PackedMesh
+  PackedMesh next(uint32_t maxFaces);
+  bool isDone() const;
+  // 已输出的面数 / 总面数
+  double getProgress() const;
+
+private:
+  TopoDS_Shape shape;
+  MeshOptions options;
+  bool isMeshed;
+  std::vector<TopoDS_Face> faces;
+  size_t cursor;
+  TopTools_IndexedDataMapOfShapeListOfShape edgeFaces;
+  TopTools_MapOfShape meshedFaces;
+  TopTools_MapOfShape emittedEdges;
+};
+
+class Mesher {
+public:
+  static PackedMesh toPackedMesh(const TopoDS_Shape& shape, const MeshOptions& options);
+  // 一次划分多个零件，结果共用一组缓冲，按 partRange 区分
+  static PackedMesh toPackedShapes(const std::vector<TopoDS_Shape>& shapes, const MeshOptions& options);
+  // 按深度优先顺序收集带 shape 的节点后调用 toPackedShapes
+  static PackedMesh toPackedAssembly(const ShapeNode& root, const MeshOptions& options);
+  // 同步地逐批划分，每批完成后调用 callback(chunk, progress)，callback 返回 false 时停止
+  static void streamPackedMesh(const TopoDS_Shape& shape, const MeshOptions& options, uint32_t batchFaces,
+      const emscripten::val& callback);
+  /**
+   * 多级 LOD，按 lineDeflection 从大到小（粗到细）返回，各级共用一次拓扑遍历。
+   * 各级 angleDeviation 随 lineDeflection 按比例放大，上限 0.5 弧度；划分在几何副本上进行，不改动 shape 已有的三角化
+   */
+  static std::vector<PackedMesh> toPackedLods(const TopoDS_Shape& shape, std::vector<double> deflections, const MeshOptions& options);
+  // normalBits 取 8 或 16
+  static QuantizedMesh quantize(const PackedMesh& packed, int normalBits);
+  /**
+   * 建模操作后的增量网格：与 previous 中 IsSame 的面和边直接复制数据块，
+   * 其余面按 options 划分并读取。previous 应由相同 options 生成
+   */
+  static PackedMesh retessellate(const TopoDS_Shape& shape, const PackedMesh& previous, const MeshOptions& options);
+
+  // 线程池大小，count <= 0 时取逻辑核数，不超过构建时的 Worker 数；单线程版本恒为 1
+  static int setThreadCount(int count);
+  static int getThreadCount();
+  // 未显式传入 parallel 的网格划分（toBRepResult、triangulate、exportSTL 等）使用该默认值
+  static void setParallel(bool parallel);
+  static bool isParallel();
+};
+
+namespace MeshBindings {
+    void registerBindings();
+}
+
+#endif // MESH_BINDINGS_H
@@ -8,8 +8,109 @@
 #include <gp_TrsfForm.hxx>
 #include <gp_EulerSequence.hxx>
 
+#include <algorithm>
+
 using namespace emscripten;
 
+// ==================== HeapBuffer ====================
+
+val HeapBuffer::allocate(size_t size) {
+  chunks.emplace_back(size);
+  totalSize += size;
+  return toMemoryView(chunks.back());
+}
+
+void HeapBuffer::append(const Uint8Array& chunk) {
+  allocate(chunk["length"].as<size_t>()).call<void>("set", chunk);
+}
+
+void HeapBuffer::adopt(std::vector<uint8_t>&& chunk) {
+  totalSize += chunk.size();
+  chunks.push_back(std::move(chunk));
+}
+
+size_t HeapBuffer::size() const {
+  return totalSize;
+}
+
+val HeapBuffer::getViews() const {
+  val views = val::array();
+  for (const auto& chunk : chunks) {
+    views.call<void>("push", toMemoryView(chunk));
+  }
+  return views;
+}
+
+void HeapBuffer::clear() {
+  std::vector<std::vector<uint8_t>>().swap(chunks);
+  totalSize = 0;
+}
+
+HeapBufferStreamBuf::HeapBufferStreamBuf(const HeapBuffer& buffer)
+    : chunks(buffer.getChunks()), current(0) {
+  size_t start = 0;
+  chunkStarts.reserve(chunks.size() + 1);
+  for (const auto& chunk : chunks) {
+    chunkStarts.push_back(start);
+    start += chunk.size();
+  }
+  chunkStarts.push_back(start);
+  setChunk(0, 0);
+}
+
+bool HeapBufferStreamBuf::setChunk(size_t index, size_t offset) {
+  current = index;
+  if (index >= chunks.size()) {
+    setg(nullptr, nullptr, nullptr);
+    return false;
+  }
+  char* begin = const_cast<char*>(reinterpret_cast<const char*>(chunks[index].data()));
+  setg(begin, begin + offset, begin + chunks[index].size());
+  return true;
+}
+
+HeapBufferStreamBuf::int_type HeapBufferStreamBuf::underflow() {
+  if (gptr() != nullptr && gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+  // 跳过空块
+  size_t next = current + 1;
+  while (next < chunks.size() && chunks[next].empty()) {
+    next++;
+  }
+  if (!setChunk(next, 0)) {
+    return traits_type::eof();
+  }
+  return traits_type::to_int_type(*gptr());
+}
+
+HeapBufferStreamBuf::pos_type HeapBufferStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir,
+    std::ios_base::openmode which) {
+  off_type base = 0;
+  if (dir == std::ios_base::cur) {
+    base = current < chunks.size() ? static_cast<off_type>(chunkStarts[current] + (gptr() - eback())) : static_cast<off_type>(chunkStarts.back());
+  } else if (dir == std::ios_base::end) {
+    base = static_cast<off_type>(chunkStarts.back());
+  }
+  return seekpos(pos_type(base + off), which);
+}
+
+HeapBufferStreamBuf::pos_type HeapBufferStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which) {
+  const off_type offset = static_cast<off_type>(pos);
+  if (!(which & std::ios_base::in) || offset < 0 || static_cast<size_t>(offset) > chunkStarts.back()) {
+    return pos_type(off_type(-1));
+  }
+  // 定位到包含 offset 的块，末尾位置落在最后一块之后
+  auto it = std::upper_bound(chunkStarts.begin(), chunkStarts.end() - 1, static_cast<size_t>(offset));
+  const size_t index = static_cast<size_t>(it - chunkStarts.begin()) - 1;
+  if (static_cast<size_t>(offset) == chunkStarts.back()) {
+    setChunk(chunks.size(), 0);
+  } else {
+    setChunk(index, static_cast<size_t>(offset) - chunkStarts[index]);
+  }
+  return pos;
+}
+
 EMSCRIPTEN_BINDINGS(Shared) {
   register_type<Int8Array>("Int8Array");
   register_type<Int16Array>("Int16Array");
@@ -67,6 +168,14 @@ EMSCRIPTEN_BINDINGS(Shared) {
       .field("min", &BoundingBox3::min)
       .field("max", &BoundingBox3::max);
 
+  class_<HeapBuffer>("HeapBuffer")
+      .constructor<>()
+      .function("allocate", &HeapBuffer::allocate)
+      .function("append", &HeapBuffer::append)
+      .function("size", &HeapBuffer::size)
+      .function("getViews", &HeapBuffer::getViews)
+      .function("clear", &HeapBuffer::clear);
+
   class_<TopoResult>("TopoResult")
       .function("takeShape", &TopoResult::takeShape, return_value_policy::take_ownership())
       .property("shape", &TopoResult::shape, return_value_policy::reference())
@@ -16,7 +16,10 @@
 #include <TopTools_SequenceOfShape.hxx>
 #include <TopTools_ListOfShape.hxx>
 #include <cmath>
+#include <cstdint>
+#include <streambuf>
 #include <utility>
+#include <vector>
 
 #define REGISTER_HANDLE(T)                                                    \
     class_<Handle(T)>("Handle_" #T)                                           \
@@ -237,6 +240,103 @@ EMSCRIPTEN_DECLARE_VAL_TYPE(TopoSolidArray)
 EMSCRIPTEN_DECLARE_VAL_TYPE(TopoCompoundArray)
 EMSCRIPTEN_DECLARE_VAL_TYPE(GpPntArray)
 
+template<typename T> struct TypedArrayName;
+template<> struct TypedArrayName<int8_t>   { static constexpr const char* value = "Int8Array"; };
+template<> struct TypedArrayName<int16_t>  { static constexpr const char* value = "Int16Array"; };
+template<> struct TypedArrayName<int32_t>  { static constexpr const char* value = "Int32Array"; };
+template<> struct TypedArrayName<uint8_t>  { static constexpr const char* value = "Uint8Array"; };
+template<> struct TypedArrayName<uint16_t> { static constexpr const char* value = "Uint16Array"; };
+template<> struct TypedArrayName<uint32_t> { static constexpr const char* value = "Uint32Array"; };
+template<> struct TypedArrayName<float>    { static constexpr const char* value = "Float32Array"; };
+template<> struct TypedArrayName<double>   { static constexpr const char* value = "Float64Array"; };
+
+/**
+ * 直接引用 wasm 堆上的数据，不发生拷贝。
+ * 视图在数据所属对象释放或 wasm 内存增长后失效，需要长期持有时请在 JS 侧 slice()。
+ */
+template<typename T>
+emscripten::val toMemoryView(const T* data, size_t size) {
+    return emscripten::val(emscripten::typed_memory_view(size, data));
+}
+
+template<typename T>
+emscripten::val toMemoryView(const std::vector<T>& vec) {
+    return toMemoryView(vec.data(), vec.size());
+}
+
+/** 整块拷贝到新的 TypedArray，只跨越一次 embind 边界 */
+template<typename T>
+emscripten::val copyToTypedArray(const T* data, size_t size) {
+    return emscripten::val::global(TypedArrayName<T>::value).new_(toMemoryView(data, size));
+}
+
+template<typename T>
+emscripten::val copyToTypedArray(const std::vector<T>& vec) {
+    return copyToTypedArray(vec.data(), vec.size());
+}
+
+/** Uint8Array 整块拷贝到 std::vector，只跨越一次 embind 边界 */
+inline std::vector<uint8_t> uint8ArrayToVector(const Uint8Array& array) {
+    std::vector<uint8_t> result(array["length"].as<size_t>());
+    toMemoryView(result).call<void>("set", array);
+    return result;
+}
+
+/**
+ * 由 JS 直接写入的 wasm 堆缓冲，用于大文件导入，避免逐元素转换和整份重复拷贝。
+ * 数据分块存放，追加时不会因扩容整体复制：
+ * 一次性写入：buffer.allocate(bytes.length).set(bytes)
+ * 流式写入：对 ReadableStream 的每个 chunk 调用 buffer.append(chunk)
+ */
+class HeapBuffer {
+public:
+  // 追加一块 size 字节的空间并返回其可写视图，需在下一次 wasm 内存分配前写入
+  emscripten::val allocate(size_t size);
+  // 追加 chunk 的拷贝
+  void append(const Uint8Array& chunk);
+  // 接管 C++ 侧已生成的数据作为新的一块，不拷贝
+  void adopt(std::vector<uint8_t>&& chunk);
+  size_t size() const;
+  // 各块数据的视图数组，如 new Blob(buffer.getViews())，需在下一次 wasm 内存分配前使用
+  emscripten::val getViews() const;
+  // 释放全部数据
+  void clear();
+
+  const std::vector<std::vector<uint8_t>>& getChunks() const { return chunks; }
+
+private:
+  std::vector<std::vector<uint8_t>> chunks;
+  size_t totalSize = 0;
+};
+
+/** 按顺序读取 HeapBuffer 各块的 streambuf，支持 seek，供 OCCT 的 ReadStream 使用 */
+class HeapBufferStreamBuf : public std::streambuf {
+public:
+  explicit HeapBufferStreamBuf(const HeapBuffer& buffer);
+
+protected:
+  int_type underflow() override;
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+  bool setChunk(size_t index, size_t offset);
+
+  const std::vector<std::vector<uint8_t>>& chunks;
+  std::vector<size_t> chunkStarts;
+  size_t current;
+};
+
+/** TopoDS 对象数组转为 JS 数组，元素为各自的拷贝 */
+template<typename TopoType>
+emscripten::val topoVectorToArray(const std::vector<TopoType>& shapes) {
+    emscripten::val result = emscripten::val::array();
+    for (const auto& shape : shapes) {
+        result.call<void>("push", shape);
+    }
+    return result;
+}
+
 inline TopTools_SequenceOfShape topoShapeArrayToSequenceOfShape(const TopoShapeArray& shapes) {
     std::vector<TopoDS_Shape> shapeSequence = emscripten::vecFromJSArray<TopoDS_Shape>(shapes);
     TopTools_SequenceOfShape result;